@@ -0,0 +1,184 @@
+#include "BatchKernel.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define QAP_X86
+#endif
+
+
+void calculatePathsScalar(
+    const Matrix& distances,
+    const Matrix& amounts,
+    const int* factories,
+    Cost* costs
+)
+{
+    int size = static_cast<int>(distances.size());
+    for (int lane = 0; lane < BATCH_SIZE; lane++) {
+        const int* permutation = factories + lane * size;
+        Cost path = 0;
+        for (int i = 0; i < size; i++) {
+            const int* distanceRow = distances[i];
+            const int* amountRow = amounts[permutation[i]];
+            for (int j = 0; j < size; j++) {
+                path += static_cast<Cost>(distanceRow[j]) * amountRow[permutation[j]];
+            }
+        }
+        costs[lane] = path;
+    }
+}
+
+namespace
+{
+Cost getMaxAbs(const Matrix& matrix)
+{
+    Cost maxAbs = 0;
+    for (std::size_t i = 0; i < matrix.size() * matrix.size(); i++) {
+        maxAbs = std::max(maxAbs, std::abs(static_cast<Cost>(matrix.data()[i])));
+    }
+    return maxAbs;
+}
+}
+
+bool fitsInt32Lanes(const Matrix& distances, const Matrix& amounts)
+{
+    Cost laneBound = getMaxAbs(distances) * getMaxAbs(amounts);
+    return laneBound == 0 || laneBound <= INT32_MAX / static_cast<Cost>(distances.size());
+}
+
+#ifdef QAP_X86
+
+// Векторные ядра не собирают значения amounts[f_i][f_j] по одному: строка
+// amounts[f_i] целиком лежит в регистре, и перестановка её элементов по
+// индексам f_j даёт все значения строки за одну инструкцию.
+
+__attribute__((target("avx2")))
+__m256i lookupAvx2(__m256i tableLow, __m256i tableHigh, __m256i indexes)
+{
+    __m256i low = _mm256_permutevar8x32_epi32(tableLow, indexes);
+    __m256i high = _mm256_permutevar8x32_epi32(tableHigh, indexes);
+    __m256i isHigh = _mm256_cmpgt_epi32(indexes, _mm256_set1_epi32(7));
+    return _mm256_blendv_epi8(low, high, isHigh);
+}
+
+__attribute__((target("avx2")))
+void calculatePathsAvx2(
+    const Matrix& distances,
+    const Matrix& amounts,
+    const int* factories,
+    Cost* costs
+)
+{
+    const int LANES = 8;
+    int size = static_cast<int>(distances.size());
+    __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i maskLow = _mm256_cmpgt_epi32(_mm256_set1_epi32(size), lanes);
+    __m256i maskHigh = _mm256_cmpgt_epi32(_mm256_set1_epi32(size - LANES), lanes);
+
+    __m256i distanceLow[SIMD_MAX_SIZE];
+    __m256i distanceHigh[SIMD_MAX_SIZE];
+    for (int i = 0; i < size; i++) {
+        distanceLow[i] = _mm256_maskload_epi32(distances[i], maskLow);
+        distanceHigh[i] = _mm256_maskload_epi32(distances[i] + LANES, maskHigh);
+    }
+
+    for (int lane = 0; lane < BATCH_SIZE; lane++) {
+        const int* permutation = factories + lane * size;
+        __m256i indexLow = _mm256_maskload_epi32(permutation, maskLow);
+        __m256i indexHigh = _mm256_maskload_epi32(permutation + LANES, maskHigh);
+        __m256i pathLow = _mm256_setzero_si256();
+        __m256i pathHigh = _mm256_setzero_si256();
+
+        for (int i = 0; i < size; i++) {
+            const int* amountRow = amounts[permutation[i]];
+            __m256i tableLow = _mm256_maskload_epi32(amountRow, maskLow);
+            __m256i tableHigh = _mm256_maskload_epi32(amountRow + LANES, maskHigh);
+
+            __m256i valuesLow = lookupAvx2(tableLow, tableHigh, indexLow);
+            __m256i valuesHigh = lookupAvx2(tableLow, tableHigh, indexHigh);
+            pathLow = _mm256_add_epi32(pathLow, _mm256_mullo_epi32(valuesLow, distanceLow[i]));
+            pathHigh = _mm256_add_epi32(pathHigh, _mm256_mullo_epi32(valuesHigh, distanceHigh[i]));
+        }
+
+        __m256i path = _mm256_add_epi64(
+            _mm256_add_epi64(
+                _mm256_cvtepi32_epi64(_mm256_castsi256_si128(pathLow)),
+                _mm256_cvtepi32_epi64(_mm256_extracti128_si256(pathLow, 1))),
+            _mm256_add_epi64(
+                _mm256_cvtepi32_epi64(_mm256_castsi256_si128(pathHigh)),
+                _mm256_cvtepi32_epi64(_mm256_extracti128_si256(pathHigh, 1))));
+        alignas(32) Cost parts[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(parts), path);
+        costs[lane] = parts[0] + parts[1] + parts[2] + parts[3];
+    }
+}
+
+__attribute__((target("avx512f")))
+void calculatePathsAvx512(
+    const Matrix& distances,
+    const Matrix& amounts,
+    const int* factories,
+    Cost* costs
+)
+{
+    int size = static_cast<int>(distances.size());
+    __mmask16 mask = static_cast<__mmask16>((1u << size) - 1);
+
+    __m512i distanceRows[SIMD_MAX_SIZE];
+    for (int i = 0; i < size; i++) {
+        distanceRows[i] = _mm512_maskz_loadu_epi32(mask, distances[i]);
+    }
+
+    for (int lane = 0; lane < BATCH_SIZE; lane++) {
+        const int* permutation = factories + lane * size;
+        __m512i indexes = _mm512_maskz_loadu_epi32(mask, permutation);
+        __m512i path = _mm512_setzero_si512();
+
+        for (int i = 0; i < size; i++) {
+            __m512i table = _mm512_maskz_loadu_epi32(mask, amounts[permutation[i]]);
+            __m512i values = _mm512_permutexvar_epi32(indexes, table);
+            path = _mm512_add_epi32(path, _mm512_mullo_epi32(values, distanceRows[i]));
+        }
+        __m512i widePath = _mm512_add_epi64(
+            _mm512_cvtepi32_epi64(_mm512_castsi512_si256(path)),
+            _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(path, 1)));
+        costs[lane] = _mm512_reduce_add_epi64(widePath);
+    }
+}
+
+BatchKernel selectBatchKernel(const Matrix& distances, const Matrix& amounts)
+{
+    if (distances.size() > SIMD_MAX_SIZE || !fitsInt32Lanes(distances, amounts)) {
+        return calculatePathsScalar;
+    }
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return calculatePathsAvx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return calculatePathsAvx2;
+    }
+    return calculatePathsScalar;
+}
+
+#else
+
+void calculatePathsAvx2(const Matrix& distances, const Matrix& amounts, const int* factories, Cost* costs)
+{
+    calculatePathsScalar(distances, amounts, factories, costs);
+}
+
+void calculatePathsAvx512(const Matrix& distances, const Matrix& amounts, const int* factories, Cost* costs)
+{
+    calculatePathsScalar(distances, amounts, factories, costs);
+}
+
+BatchKernel selectBatchKernel(const Matrix& distances, const Matrix& amounts)
+{
+    return calculatePathsScalar;
+}
+
+#endif
@@ -0,0 +1,26 @@
+#pragma once
+#include "Qap.h"
+
+
+// Число перестановок, оцениваемых за один вызов ядра
+const int BATCH_SIZE = 16;
+// Наибольший размер, при котором строка матрицы помещается в один регистр AVX-512
+const int SIMD_MAX_SIZE = 16;
+
+// factories хранит пачку из BATCH_SIZE перестановок подряд:
+// factories[lane * size + location] - фабрика на позиции location в перестановке lane.
+// В costs записываются потоки всех перестановок пачки.
+using BatchKernel = void (*)(const Matrix& distances, const Matrix& amounts, const int* factories, Cost* costs);
+
+void calculatePathsScalar(const Matrix& distances, const Matrix& amounts, const int* factories, Cost* costs);
+void calculatePathsAvx2(const Matrix& distances, const Matrix& amounts, const int* factories, Cost* costs);
+void calculatePathsAvx512(const Matrix& distances, const Matrix& amounts, const int* factories, Cost* costs);
+
+// Векторные ядра складывают size произведений в 32-битной дорожке. true, если
+// max|distance| * max|amount| * size помещается в int32 и переполнения нет.
+bool fitsInt32Lanes(const Matrix& distances, const Matrix& amounts);
+
+// Выбирает самое широкое ядро, которое поддерживает процессор. Векторные ядра
+// держат строку матрицы в регистре, поэтому используются только при
+// size <= SIMD_MAX_SIZE и только если fitsInt32Lanes.
+BatchKernel selectBatchKernel(const Matrix& distances, const Matrix& amounts);
@@ -0,0 +1,191 @@
+#include "BatchSolver.h"
+#include "BranchAndBound.h"
+#include "Loader.h"
+#include "Symmetry.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+
+struct BatchResult
+{
+    std::string name;
+    Placement placement;
+    int size = 0;
+    double seconds = 0;
+    std::string error;
+};
+
+
+std::vector<BatchInstance> getDirectoryInstances(const std::filesystem::path& directory)
+{
+    std::vector<BatchInstance> instances;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".dat") {
+            instances.push_back({entry.path().filename().string(), {entry.path().string()}});
+        }
+    }
+    std::sort(instances.begin(), instances.end(), [](const auto& left, const auto& right) {
+        return left.name < right.name;
+    });
+    return instances;
+}
+
+std::vector<BatchInstance> getManifestInstances(const std::filesystem::path& manifest)
+{
+    std::ifstream file(manifest);
+    if (!file.is_open()) {
+        throw std::runtime_error("Ошибка открытия файла " + manifest.string());
+    }
+
+    std::vector<BatchInstance> instances;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::vector<std::string> fileNames;
+        std::string fileName;
+        while (iss >> fileName) {
+            fileNames.push_back((manifest.parent_path() / fileName).string());
+        }
+        if (fileNames.empty() || line[line.find_first_not_of(" \t")] == '#') {
+            continue;
+        }
+        if (fileNames.size() > 2) {
+            throw std::runtime_error("Неверная строка в списке задач: " + line);
+        }
+        auto name = line.substr(line.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t\r") + 1);
+        instances.push_back({name, fileNames});
+    }
+    return instances;
+}
+
+std::vector<BatchInstance> getBatchInstances(const std::string& path)
+{
+    if (std::filesystem::is_directory(path)) {
+        return getDirectoryInstances(path);
+    }
+    return getManifestInstances(path);
+}
+
+ResultFormat getResultFormat(const std::string& fileName)
+{
+    return std::filesystem::path(fileName).extension() == ".jsonl" ? ResultFormat::Jsonl : ResultFormat::Csv;
+}
+
+std::string escapeCsv(const std::string& value)
+{
+    if (value.find_first_of(",\"\n") == std::string::npos) {
+        return value;
+    }
+    std::string escaped = "\"";
+    for (char symbol : value) {
+        escaped += symbol;
+        if (symbol == '"') {
+            escaped += '"';
+        }
+    }
+    return escaped + "\"";
+}
+
+std::string escapeJson(const std::string& value)
+{
+    std::string escaped = "\"";
+    for (char symbol : value) {
+        if (symbol == '"' || symbol == '\\') {
+            escaped += '\\';
+            escaped += symbol;
+        } else if (symbol == '\n') {
+            escaped += "\\n";
+        } else if (static_cast<unsigned char>(symbol) < 0x20) {
+            escaped += ' ';
+        } else {
+            escaped += symbol;
+        }
+    }
+    return escaped + "\"";
+}
+
+std::string joinFactories(const std::vector<int>& factories, char separator)
+{
+    std::ostringstream joined;
+    for (std::size_t i = 0; i < factories.size(); i++) {
+        if (i != 0) {
+            joined << separator;
+        }
+        joined << factories[i];
+    }
+    return joined.str();
+}
+
+void writeResult(std::ostream& output, ResultFormat format, const BatchResult& result)
+{
+    if (format == ResultFormat::Csv) {
+        output << escapeCsv(result.name) << ',' << result.size << ',';
+        if (result.error.empty()) {
+            output << result.placement.cost;
+        }
+        output << ',' << joinFactories(result.placement.factories, ' ')
+               << ',' << result.seconds << ',' << escapeCsv(result.error) << '\n';
+        return;
+    }
+
+    output << "{\"instance\":" << escapeJson(result.name) << ",\"size\":" << result.size;
+    if (result.error.empty()) {
+        output << ",\"cost\":" << result.placement.cost
+               << ",\"factories\":[" << joinFactories(result.placement.factories, ',') << ']';
+    } else {
+        output << ",\"error\":" << escapeJson(result.error);
+    }
+    output << ",\"seconds\":" << result.seconds << "}\n";
+}
+
+void solveBatch(
+    const std::vector<BatchInstance>& instances,
+    ThreadPool& pool,
+    std::ostream& output,
+    ResultFormat format,
+    bool useSymmetry,
+    bool isTransposable
+)
+{
+    std::mutex outputMutex;
+    if (format == ResultFormat::Csv) {
+        output << "instance,size,cost,factories,seconds,error\n";
+    }
+
+    for (const auto& instance : instances) {
+        pool.submit([&] {
+            BatchResult result;
+            result.name = instance.name;
+            auto startTime = Clock::now();
+            try {
+                auto matrices = loadInstance(instance.fileNames);
+                result.size = static_cast<int>(matrices.distances.size());
+                SymmetryInfo symmetry;
+                if (useSymmetry) {
+                    symmetry = detectSymmetry(matrices.distances, matrices.amounts, isTransposable);
+                }
+                result.placement = solveReduced(
+                    matrices.distances,
+                    matrices.amounts,
+                    symmetry,
+                    [](const Matrix& distances, const Matrix& amounts, const Automorphisms& automorphisms) {
+                        return BranchAndBound(distances, amounts, automorphisms).solve();
+                    }
+                );
+            } catch (const std::exception& exception) {
+                result.error = exception.what();
+            }
+            result.seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+
+            std::lock_guard<std::mutex> lock(outputMutex);
+            writeResult(output, format, result);
+            output.flush();
+        });
+    }
+    pool.wait();
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "Qap.h"
+#include "ThreadPool.h"
+#include <ostream>
+#include <string>
+
+
+struct BatchInstance
+{
+    std::string name;
+    // Один файл QAPLIB или пара файлов расстояний и потоков
+    std::vector<std::string> fileNames;
+};
+
+enum class ResultFormat
+{
+    Csv,
+    Jsonl,
+};
+
+// Каталог - все файлы .dat в нём. Иначе path - список задач: по одной на
+// строку, один файл QAPLIB или два файла матриц через пробел. Относительные
+// пути отсчитываются от каталога списка, строки с # пропускаются.
+std::vector<BatchInstance> getBatchInstances(const std::string& path);
+ResultFormat getResultFormat(const std::string& fileName);
+
+// Решает все задачи методом ветвей и границ, по задаче на поток пула. Симметрии
+// учитываются при useSymmetry, транспонирование задачи - при isTransposable.
+// Строка результата пишется сразу после решения задачи, поэтому их порядок
+// не совпадает с порядком задач. Ошибка загрузки попадает в строку задачи
+// и не прерывает остальные.
+void solveBatch(
+    const std::vector<BatchInstance>& instances,
+    ThreadPool& pool,
+    std::ostream& output,
+    ResultFormat format,
+    bool useSymmetry = true,
+    bool isTransposable = false
+);
@@ -0,0 +1,303 @@
+#include "BranchAndBound.h"
+#include <numeric>
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+
+const Automorphisms NO_AUTOMORPHISMS;
+
+
+BranchAndBound::BranchAndBound(const Matrix& distances, const Matrix& amounts)
+    : BranchAndBound(distances, amounts, NO_AUTOMORPHISMS)
+{
+}
+
+DistanceBounds::DistanceBounds(const Matrix& distances)
+    : m_size(static_cast<int>(distances.size()))
+    , m_rows(m_size * m_size)
+{
+    for (int location = 0; location < m_size; location++) {
+        for (int i = location; i < m_size; i++) {
+            auto& row = m_rows[location * m_size + i];
+            for (int j = location; j < m_size; j++) {
+                if (j != i) {
+                    row.push_back(distances[i][j]);
+                }
+            }
+            std::sort(row.begin(), row.end());
+        }
+    }
+}
+
+const Cost* DistanceBounds::getSortedRow(int location, int i) const
+{
+    return m_rows[location * m_size + i].data();
+}
+
+
+BranchAndBound::BranchAndBound(
+    const Matrix& distances,
+    const Matrix& amounts,
+    const Automorphisms& factoryAutomorphisms
+)
+    : BranchAndBound(distances, amounts, factoryAutomorphisms, std::make_shared<DistanceBounds>(distances))
+{
+}
+
+BranchAndBound::BranchAndBound(
+    const Matrix& distances,
+    const Matrix& amounts,
+    const Automorphisms& factoryAutomorphisms,
+    std::shared_ptr<const DistanceBounds> distanceBounds
+)
+    : m_distances(distances)
+    , m_amounts(amounts)
+    , m_size(static_cast<int>(distances.size()))
+    , m_factories(m_size)
+    , m_usedFactories(m_size, false)
+    , m_interactions(m_size + 1, std::vector<Cost>(m_size * m_size, 0))
+    , m_automorphisms(factoryAutomorphisms)
+    , m_distanceBounds(std::move(distanceBounds))
+    , m_stabilizers(m_size + 1)
+{
+    m_stabilizers[0].resize(m_automorphisms.size());
+    std::iota(m_stabilizers[0].begin(), m_stabilizers[0].end(), 0);
+}
+
+Placement BranchAndBound::solve(Cost upperBound)
+{
+    // Тождественная расстановка лексикографически первая, поэтому её можно
+    // взять начальным рекордом, не меняя результата при равных потоках
+    std::vector<int> identity(m_size);
+    std::iota(identity.begin(), identity.end(), 0);
+    Cost identityCost = calculatePath(m_distances, m_amounts, identity);
+    if (upperBound < identityCost) {
+        // Расстановка с потоком upperBound может оказаться не первой среди
+        // оптимальных, поэтому оценка работает как общий рекорд solveSubtree
+        std::atomic<Cost> bound = upperBound;
+        auto best = solveSubtree({}, bound);
+        m_sharedBound = nullptr;
+        return best;
+    }
+
+    m_best = {identity, identityCost};
+    branch(0, 0);
+    return m_best;
+}
+
+Placement BranchAndBound::solveSubtree(const std::vector<int>& prefix, std::atomic<Cost>& sharedBound)
+{
+    m_sharedBound = &sharedBound;
+    m_best.factories.clear();
+    m_best.cost = std::numeric_limits<Cost>::max();
+
+    Cost fixedCost = 0;
+    for (int location = 0; location < static_cast<int>(prefix.size()); location++) {
+        int factory = prefix[location];
+        if (getRedundantFactories(location)[factory]) {
+            return m_best;
+        }
+        fixedCost += static_cast<Cost>(m_distances[location][location]) * m_amounts[factory][factory]
+            + m_interactions[location][location * m_size + factory];
+        assign(location, factory);
+    }
+    int location = static_cast<int>(prefix.size());
+    if (location == m_size || canImprove(getLowerBound(location, fixedCost))) {
+        branch(location, fixedCost);
+    }
+    return m_best;
+}
+
+void BranchAndBound::setOnImprove(std::function<void(const Placement&)> onImprove)
+{
+    m_onImprove = std::move(onImprove);
+}
+
+bool BranchAndBound::canImprove(Cost lowerBound) const
+{
+    if (lowerBound >= m_best.cost) {
+        return false;
+    }
+    return m_sharedBound == nullptr || lowerBound <= m_sharedBound->load(std::memory_order_relaxed);
+}
+
+void BranchAndBound::updateBest(Cost cost)
+{
+    m_best.cost = cost;
+    m_best.factories = m_factories;
+    if (m_sharedBound == nullptr) {
+        return;
+    }
+    Cost shared = m_sharedBound->load(std::memory_order_relaxed);
+    while (cost < shared && !m_sharedBound->compare_exchange_weak(shared, cost)) {
+    }
+    if (cost < shared && m_onImprove) {
+        m_onImprove(m_best);
+    }
+}
+
+void BranchAndBound::branch(int location, Cost fixedCost)
+{
+    if (location == m_size) {
+        if (fixedCost < m_best.cost) {
+            updateBest(fixedCost);
+        }
+        return;
+    }
+
+    auto redundantFactories = getRedundantFactories(location);
+    for (int factory = 0; factory < m_size; factory++) {
+        if (m_usedFactories[factory] || redundantFactories[factory]) {
+            continue;
+        }
+        Cost childCost = fixedCost
+            + static_cast<Cost>(m_distances[location][location]) * m_amounts[factory][factory]
+            + m_interactions[location][location * m_size + factory];
+
+        assign(location, factory);
+        if (location + 1 == m_size || canImprove(getLowerBound(location + 1, childCost))) {
+            branch(location + 1, childCost);
+        }
+        unassign(factory);
+    }
+}
+
+void BranchAndBound::assign(int location, int factory)
+{
+    m_factories[location] = factory;
+    m_usedFactories[factory] = true;
+
+    auto& stabilizers = m_stabilizers[location + 1];
+    stabilizers.clear();
+    for (int index : m_stabilizers[location]) {
+        if (m_automorphisms[index][factory] == factory) {
+            stabilizers.push_back(index);
+        }
+    }
+
+    const auto& previous = m_interactions[location];
+    auto& next = m_interactions[location + 1];
+    for (int i = location + 1; i < m_size; i++) {
+        for (int f = 0; f < m_size; f++) {
+            next[i * m_size + f] = previous[i * m_size + f]
+                + static_cast<Cost>(m_distances[i][location]) * m_amounts[f][factory]
+                + static_cast<Cost>(m_distances[location][i]) * m_amounts[factory][f];
+        }
+    }
+}
+
+std::vector<bool> BranchAndBound::getRedundantFactories(int location) const
+{
+    std::vector<bool> redundant(m_size, false);
+    for (int index : m_stabilizers[location]) {
+        const auto& automorphism = m_automorphisms[index];
+        for (int factory = 0; factory < m_size; factory++) {
+            if (automorphism[factory] < factory) {
+                redundant[factory] = true;
+            }
+        }
+    }
+    return redundant;
+}
+
+void BranchAndBound::unassign(int factory)
+{
+    m_usedFactories[factory] = false;
+}
+
+Cost BranchAndBound::getLowerBound(int location, Cost fixedCost) const
+{
+    std::vector<int> freeFactories;
+    for (int factory = 0; factory < m_size; factory++) {
+        if (!m_usedFactories[factory]) {
+            freeFactories.push_back(factory);
+        }
+    }
+    int freeCount = m_size - location;
+
+    // Минимальное скалярное произведение строки расстояний и строки потоков
+    // получается при сортировке одной по возрастанию, а другой по убыванию.
+    // Строки расстояний отсортированы заранее в m_distanceBounds.
+    std::vector<std::vector<Cost>> amountRows(freeCount);
+    for (int k = 0; k < freeCount; k++) {
+        int f = freeFactories[k];
+        for (int l = 0; l < freeCount; l++) {
+            if (l != k) {
+                amountRows[k].push_back(m_amounts[f][freeFactories[l]]);
+            }
+        }
+        std::sort(amountRows[k].begin(), amountRows[k].end(), std::greater<>());
+    }
+
+    std::vector<Cost> costs(freeCount * freeCount);
+    for (int k = 0; k < freeCount; k++) {
+        int i = location + k;
+        const Cost* distanceRow = m_distanceBounds->getSortedRow(location, i);
+        for (int l = 0; l < freeCount; l++) {
+            int f = freeFactories[l];
+            Cost cost = static_cast<Cost>(m_distances[i][i]) * m_amounts[f][f]
+                + m_interactions[location][i * m_size + f];
+            for (int t = 0; t + 1 < freeCount; t++) {
+                cost += distanceRow[t] * amountRows[l][t];
+            }
+            costs[k * freeCount + l] = cost;
+        }
+    }
+    return fixedCost + solveAssignment(costs, freeCount);
+}
+
+// Венгерский алгоритм для квадратной матрицы стоимостей size x size
+Cost solveAssignment(const std::vector<Cost>& costs, int size)
+{
+    const Cost INF = std::numeric_limits<Cost>::max() / 4;
+    std::vector<Cost> u(size + 1, 0);
+    std::vector<Cost> v(size + 1, 0);
+    std::vector<int> match(size + 1, 0);
+    std::vector<int> way(size + 1, 0);
+
+    for (int row = 1; row <= size; row++) {
+        match[0] = row;
+        int column = 0;
+        std::vector<Cost> minValues(size + 1, INF);
+        std::vector<bool> used(size + 1, false);
+        do
+        {
+            used[column] = true;
+            int currentRow = match[column];
+            int nextColumn = 0;
+            Cost delta = INF;
+            for (int j = 1; j <= size; j++) {
+                if (used[j]) {
+                    continue;
+                }
+                Cost current = costs[(currentRow - 1) * size + j - 1] - u[currentRow] - v[j];
+                if (current < minValues[j]) {
+                    minValues[j] = current;
+                    way[j] = column;
+                }
+                if (minValues[j] < delta) {
+                    delta = minValues[j];
+                    nextColumn = j;
+                }
+            }
+            for (int j = 0; j <= size; j++) {
+                if (used[j]) {
+                    u[match[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    minValues[j] -= delta;
+                }
+            }
+            column = nextColumn;
+        } while (match[column] != 0);
+
+        do
+        {
+            int previousColumn = way[column];
+            match[column] = match[previousColumn];
+            column = previousColumn;
+        } while (column != 0);
+    }
+    return -v[0];
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "Qap.h"
+#include "Symmetry.h"
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+
+
+// Расстояния от позиции i до позиций location..n-1, кроме самой i,
+// отсортированные по возрастанию, для всех location <= i. Зависят только от
+// матрицы расстояний, поэтому считаются один раз и используются всеми
+// поисками с этой матрицей, в том числе после изменения потоков.
+class DistanceBounds
+{
+public:
+    explicit DistanceBounds(const Matrix& distances);
+    // Строка из n - location - 1 элементов
+    const Cost* getSortedRow(int location, int i) const;
+
+private:
+    int m_size;
+    std::vector<std::vector<Cost>> m_rows;
+};
+
+// Точный поиск: фабрики назначаются на позиции по одной в лексикографическом
+// порядке, частичные расстановки отсекаются нижней оценкой Гилмора–Лоулера.
+// Возвращает ту же расстановку, что и полный перебор findMinPath.
+// Если переданы автоморфизмы потоков, фабрика f на очередной позиции
+// пропускается, когда автоморфизм, не меняющий уже расставленные фабрики,
+// переводит f в меньшую: такая ветвь повторяет более раннюю. Лексикографически
+// наименьшая оптимальная расстановка при этом не отсекается.
+class BranchAndBound
+{
+public:
+    BranchAndBound(const Matrix& distances, const Matrix& amounts);
+    BranchAndBound(const Matrix& distances, const Matrix& amounts, const Automorphisms& factoryAutomorphisms);
+    BranchAndBound(const Matrix& distances, const Matrix& amounts, const Automorphisms& factoryAutomorphisms,
+                   std::shared_ptr<const DistanceBounds> distanceBounds);
+    // upperBound - поток известной расстановки, например решения задачи
+    // с прежними потоками. Отсекаются только ветви с оценкой строго больше,
+    // поэтому результат тот же, что без оценки.
+    Placement solve(Cost upperBound = std::numeric_limits<Cost>::max());
+    // Поиск только среди расстановок с заданным началом. Ветви отсекаются и по
+    // общему для всех потоков рекорду sharedBound, но лишь при строго большей
+    // оценке, чтобы равные по потоку расстановки из соседних поддеревьев
+    // не терялись при выборе лексикографически меньшей.
+    Placement solveSubtree(const std::vector<int>& prefix, std::atomic<Cost>& sharedBound);
+    // Вызывается из solveSubtree, когда найденная расстановка улучшает общий рекорд
+    void setOnImprove(std::function<void(const Placement&)> onImprove);
+
+private:
+    void branch(int location, Cost fixedCost);
+    bool canImprove(Cost lowerBound) const;
+    void updateBest(Cost cost);
+    void assign(int location, int factory);
+    void unassign(int factory);
+    std::vector<bool> getRedundantFactories(int location) const;
+    Cost getLowerBound(int location, Cost fixedCost) const;
+
+    const Matrix& m_distances;
+    const Matrix& m_amounts;
+    int m_size;
+
+    std::vector<int> m_factories;
+    std::vector<bool> m_usedFactories;
+    // m_interactions[d][i * n + f] - поток между фабрикой f на позиции i
+    // и уже расставленными на позиции 0..d-1 фабриками
+    std::vector<std::vector<Cost>> m_interactions;
+    const Automorphisms& m_automorphisms;
+    std::shared_ptr<const DistanceBounds> m_distanceBounds;
+    // m_stabilizers[d] - автоморфизмы, не меняющие фабрики на позициях 0..d-1
+    std::vector<std::vector<int>> m_stabilizers;
+    Placement m_best;
+    std::atomic<Cost>* m_sharedBound = nullptr;
+    std::function<void(const Placement&)> m_onImprove;
+};
+
+Cost solveAssignment(const std::vector<Cost>& costs, int size);
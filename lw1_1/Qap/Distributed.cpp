@@ -0,0 +1,431 @@
+#include "Distributed.h"
+#include "BranchAndBound.h"
+#include "ParallelSearch.h"
+#include "Loader.h"
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+const int LISTEN_BACKLOG = 64;
+const std::size_t RECEIVE_BUFFER_SIZE = 4096;
+
+
+bool sendLine(int socket, const std::string& line)
+{
+    std::string message = line + '\n';
+    std::size_t sent = 0;
+    while (sent < message.size()) {
+        ssize_t count = send(socket, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+        if (count <= 0) {
+            return false;
+        }
+        sent += count;
+    }
+    return true;
+}
+
+// Дочитывает из сокета в buffer и переносит в lines полученные целиком строки.
+// false, если соединение закрыто
+bool receiveLines(int socket, std::string& buffer, std::vector<std::string>& lines)
+{
+    char data[RECEIVE_BUFFER_SIZE];
+    ssize_t count = recv(socket, data, sizeof(data), 0);
+    if (count <= 0) {
+        return false;
+    }
+    buffer.append(data, count);
+
+    std::size_t start = 0;
+    for (auto end = buffer.find('\n'); end != std::string::npos; end = buffer.find('\n', start)) {
+        lines.push_back(buffer.substr(start, end - start));
+        start = end + 1;
+    }
+    buffer.erase(0, start);
+    return true;
+}
+
+std::string formatPlacement(const Placement& placement)
+{
+    std::string text = std::to_string(placement.cost);
+    for (int factory : placement.factories) {
+        text += ' ' + std::to_string(factory);
+    }
+    return text;
+}
+
+void tightenBound(std::atomic<Cost>& bound, Cost cost)
+{
+    Cost current = bound.load();
+    while (cost < current && !bound.compare_exchange_weak(current, cost)) {
+    }
+}
+
+
+Coordinator::Coordinator(
+    const Matrix& distances,
+    const Matrix& amounts,
+    int port
+)
+    : m_distances(distances)
+    , m_amounts(amounts)
+{
+    assertMatrixSizesAreEqual(distances, amounts);
+    m_listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_listener < 0) {
+        throw std::runtime_error("Ошибка создания сокета");
+    }
+    int enabled = 1;
+    setsockopt(m_listener, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    socklen_t length = sizeof(address);
+    if (bind(m_listener, reinterpret_cast<sockaddr*>(&address), length) != 0
+        || listen(m_listener, LISTEN_BACKLOG) != 0
+        || getsockname(m_listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        close(m_listener);
+        throw std::runtime_error("Ошибка открытия порта " + std::to_string(port));
+    }
+    m_port = ntohs(address.sin_port);
+}
+
+Coordinator::~Coordinator()
+{
+    for (auto& connection : m_connections) {
+        close(connection.socket);
+    }
+    close(m_listener);
+}
+
+int Coordinator::getPort() const
+{
+    return m_port;
+}
+
+Placement Coordinator::run(const std::function<void(const Placement&)>& onImprove)
+{
+    int size = static_cast<int>(m_distances.size());
+    m_onImprove = onImprove;
+    m_prefixes = getPrefixes(size, DISTRIBUTED_TASK_COUNT);
+    m_results.assign(m_prefixes.size(), {});
+    m_doneTasks.assign(m_prefixes.size(), false);
+    m_doneCount = 0;
+    m_pendingTasks.resize(m_prefixes.size());
+    std::iota(m_pendingTasks.begin(), m_pendingTasks.end(), 0);
+
+    m_best.factories.resize(size);
+    std::iota(m_best.factories.begin(), m_best.factories.end(), 0);
+    m_best.cost = calculatePath(m_distances, m_amounts, m_best.factories);
+
+    while (m_doneCount < m_prefixes.size()) {
+        std::vector<pollfd> sockets{{m_listener, POLLIN, 0}};
+        for (const auto& connection : m_connections) {
+            sockets.push_back({connection.socket, POLLIN, 0});
+        }
+        if (poll(sockets.data(), sockets.size(), -1) < 0) {
+            continue;
+        }
+
+        // Новые соединения добавляются в конец и в этом проходе не читаются
+        std::size_t connectionCount = m_connections.size();
+        if (sockets[0].revents & POLLIN) {
+            acceptConnection();
+        }
+        for (std::size_t i = 0; i < connectionCount; i++) {
+            if (sockets[i + 1].revents != 0 && !receive(m_connections[i])) {
+                closeConnection(m_connections[i]);
+            }
+        }
+        std::erase_if(m_connections, [](const Connection& connection) { return connection.socket < 0; });
+        assignTasks();
+    }
+    broadcast("DONE");
+
+    // Поддеревья идут в лексикографическом порядке, поэтому при равных
+    // потоках остаётся расстановка из более раннего
+    Placement best;
+    best.cost = std::numeric_limits<Cost>::max();
+    for (const auto& result : m_results) {
+        if (!result.factories.empty() && result.cost < best.cost) {
+            best = result;
+        }
+    }
+    return best;
+}
+
+void Coordinator::acceptConnection()
+{
+    int socket = accept(m_listener, nullptr, nullptr);
+    if (socket >= 0) {
+        m_connections.push_back({socket, {}, false});
+    }
+}
+
+bool Coordinator::receive(Connection& connection)
+{
+    std::vector<std::string> messages;
+    if (!receiveLines(connection.socket, connection.buffer, messages)) {
+        return false;
+    }
+    for (const auto& message : messages) {
+        if (!handleMessage(connection, message)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Coordinator::handleMessage(Connection& connection, const std::string& message)
+{
+    std::istringstream input(message);
+    std::string type;
+    input >> type;
+
+    if (type == "HELLO") {
+        std::size_t size = 0;
+        unsigned long long hash = 0;
+        input >> size >> hash;
+        if (size != m_distances.size() || hash != hashInstance(m_distances, m_amounts)) {
+            sendLine(connection.socket, "ERROR Рабочий загрузил другую задачу");
+            return false;
+        }
+        connection.ready = true;
+        return true;
+    }
+    if (!connection.ready) {
+        return false;
+    }
+
+    if (type == "IMPROVED") {
+        Placement placement;
+        if (!readPlacement(input, placement)) {
+            return false;
+        }
+        if (placement.cost < m_best.cost) {
+            m_best = placement;
+            broadcast("BOUND " + std::to_string(m_best.cost));
+            if (m_onImprove) {
+                m_onImprove(m_best);
+            }
+        }
+        return true;
+    }
+    if (type == "RESULT") {
+        int task = -1;
+        input >> task;
+        if (task != connection.task) {
+            return false;
+        }
+        Placement placement;
+        if (!message.ends_with(" NONE") && !readPlacement(input, placement)) {
+            return false;
+        }
+        m_results[task] = placement;
+        m_doneTasks[task] = true;
+        m_doneCount++;
+        connection.task = -1;
+        return true;
+    }
+    return false;
+}
+
+// Поток расстановки от рабочего пересчитывается: принимаются только
+// перестановки, поток которых совпадает с заявленным
+bool Coordinator::readPlacement(std::istream& input, Placement& placement) const
+{
+    int size = static_cast<int>(m_distances.size());
+    placement.factories.resize(size);
+    input >> placement.cost;
+    std::vector<bool> used(size, false);
+    for (int& factory : placement.factories) {
+        if (!(input >> factory) || factory < 0 || factory >= size || used[factory]) {
+            return false;
+        }
+        used[factory] = true;
+    }
+    return calculatePath(m_distances, m_amounts, placement.factories) == placement.cost;
+}
+
+void Coordinator::assignTasks()
+{
+    for (auto& connection : m_connections) {
+        if (m_pendingTasks.empty()) {
+            return;
+        }
+        if (!connection.ready || connection.task >= 0) {
+            continue;
+        }
+        int task = m_pendingTasks.front();
+        std::string message = "TASK " + std::to_string(task) + ' ' + std::to_string(m_best.cost);
+        for (int factory : m_prefixes[task]) {
+            message += ' ' + std::to_string(factory);
+        }
+        if (sendLine(connection.socket, message)) {
+            m_pendingTasks.pop_front();
+            connection.task = task;
+        }
+    }
+}
+
+void Coordinator::broadcast(const std::string& message)
+{
+    for (const auto& connection : m_connections) {
+        if (connection.ready) {
+            sendLine(connection.socket, message);
+        }
+    }
+}
+
+// Невыполненное поддерево возвращается в начало очереди
+void Coordinator::closeConnection(Connection& connection)
+{
+    if (connection.task >= 0 && !m_doneTasks[connection.task]) {
+        m_pendingTasks.push_front(connection.task);
+    }
+    close(connection.socket);
+    connection.socket = -1;
+}
+
+
+int connectToCoordinator(const std::string& host, int port)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        throw std::runtime_error("Неизвестный адрес " + host);
+    }
+
+    int result = -1;
+    for (auto* address = addresses; address != nullptr && result < 0; address = address->ai_next) {
+        int socket = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (socket < 0) {
+            continue;
+        }
+        if (connect(socket, address->ai_addr, address->ai_addrlen) == 0) {
+            result = socket;
+        } else {
+            close(socket);
+        }
+    }
+    freeaddrinfo(addresses);
+    if (result < 0) {
+        throw std::runtime_error("Ошибка подключения к " + host + ":" + std::to_string(port));
+    }
+    return result;
+}
+
+struct Task
+{
+    int id;
+    Cost bound;
+    std::vector<int> prefix;
+};
+
+// Сообщения координатора читает отдельный поток: рекорд из BOUND сразу
+// попадает в sharedBound и используется в текущем обходе
+void runWorker(
+    const Matrix& distances,
+    const Matrix& amounts,
+    const std::string& host,
+    int port,
+    const Automorphisms& factoryAutomorphisms
+)
+{
+    int socket = connectToCoordinator(host, port);
+    sendLine(socket, "HELLO " + std::to_string(distances.size()) + ' '
+                     + std::to_string(hashInstance(distances, amounts)));
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<Task> tasks;
+    bool finished = false;
+    bool completed = false;
+    std::string error;
+    std::atomic<Cost> sharedBound = std::numeric_limits<Cost>::max();
+    auto distanceBounds = std::make_shared<const DistanceBounds>(distances);
+
+    std::thread reader([&] {
+        std::string buffer;
+        std::vector<std::string> messages;
+        while (receiveLines(socket, buffer, messages)) {
+            std::lock_guard lock(mutex);
+            for (const auto& message : messages) {
+                std::istringstream input(message);
+                std::string type;
+                input >> type;
+                if (type == "TASK") {
+                    Task task;
+                    input >> task.id >> task.bound;
+                    for (int factory; input >> factory;) {
+                        task.prefix.push_back(factory);
+                    }
+                    tasks.push_back(std::move(task));
+                } else if (type == "BOUND") {
+                    Cost bound;
+                    if (input >> bound) {
+                        tightenBound(sharedBound, bound);
+                    }
+                } else if (type == "DONE") {
+                    completed = true;
+                } else if (type == "ERROR") {
+                    std::getline(input >> std::ws, error);
+                }
+            }
+            messages.clear();
+            changed.notify_all();
+        }
+        std::lock_guard lock(mutex);
+        if (!completed && error.empty()) {
+            error = "Соединение с координатором потеряно";
+        }
+        finished = true;
+        // Без координатора текущий обход бесполезен: отсекается всё
+        sharedBound = std::numeric_limits<Cost>::min();
+        changed.notify_all();
+    });
+
+    while (true) {
+        Task task;
+        {
+            std::unique_lock lock(mutex);
+            changed.wait(lock, [&] { return finished || completed || !tasks.empty(); });
+            if (finished || completed) {
+                break;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        tightenBound(sharedBound, task.bound);
+
+        BranchAndBound search(distances, amounts, factoryAutomorphisms, distanceBounds);
+        search.setOnImprove([&](const Placement& placement) {
+            sendLine(socket, "IMPROVED " + formatPlacement(placement));
+        });
+        auto result = search.solveSubtree(task.prefix, sharedBound);
+
+        std::string message = "RESULT " + std::to_string(task.id) + ' ';
+        sendLine(socket, message + (result.factories.empty() ? "NONE" : formatPlacement(result)));
+    }
+
+    shutdown(socket, SHUT_RDWR);
+    reader.join();
+    close(socket);
+    if (!completed) {
+        throw std::runtime_error(error);
+    }
+}
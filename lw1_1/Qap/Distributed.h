@@ -0,0 +1,73 @@
+#pragma once
+#include "Qap.h"
+#include "Symmetry.h"
+#include <deque>
+#include <functional>
+#include <string>
+
+
+// Распределённый метод ветвей и границ. Координатор делит перестановки на
+// поддеревья с фиксированным началом, как findMinPathParallel, и раздаёт их
+// рабочим процессам по TCP, по одному поддереву на процесс за раз. Рабочие
+// сообщают о каждом улучшении рекорда, координатор рассылает его всем для
+// отсечения. Поддерево отключившегося рабочего отдаётся другому. Результат
+// совпадает с последовательным перебором.
+//
+// Протокол текстовый, одно сообщение на строку:
+//   рабочий:     HELLO <n> <hashInstance>
+//                IMPROVED <поток> <расстановка>
+//                RESULT <номер поддерева> <поток> <расстановка> | RESULT <номер поддерева> NONE
+//   координатор: TASK <номер поддерева> <рекорд> <начало перестановки>
+//                BOUND <рекорд>
+//                DONE | ERROR <сообщение>
+
+const int DISTRIBUTED_TASK_COUNT = 1024;
+
+class Coordinator
+{
+public:
+    // Порт открывается сразу, port = 0 - любой свободный
+    Coordinator(const Matrix& distances, const Matrix& amounts, int port);
+    ~Coordinator();
+    Coordinator(const Coordinator&) = delete;
+    Coordinator& operator=(const Coordinator&) = delete;
+
+    int getPort() const;
+    // Принимает рабочих и раздаёт поддеревья, пока все не будут обойдены
+    Placement run(const std::function<void(const Placement&)>& onImprove = nullptr);
+
+private:
+    struct Connection
+    {
+        int socket;
+        std::string buffer;
+        bool ready = false;
+        int task = -1;
+    };
+
+    void acceptConnection();
+    bool receive(Connection& connection);
+    bool handleMessage(Connection& connection, const std::string& message);
+    bool readPlacement(std::istream& input, Placement& placement) const;
+    void assignTasks();
+    void broadcast(const std::string& message);
+    void closeConnection(Connection& connection);
+
+    const Matrix& m_distances;
+    const Matrix& m_amounts;
+    int m_listener = -1;
+    int m_port = 0;
+
+    std::vector<std::vector<int>> m_prefixes;
+    std::vector<Connection> m_connections;
+    std::deque<int> m_pendingTasks;
+    std::vector<Placement> m_results;
+    std::vector<bool> m_doneTasks;
+    std::size_t m_doneCount = 0;
+    Placement m_best;
+    std::function<void(const Placement&)> m_onImprove;
+};
+
+// Подключается к координатору и обходит выданные поддеревья до сообщения DONE
+void runWorker(const Matrix& distances, const Matrix& amounts, const std::string& host, int port,
+               const Automorphisms& factoryAutomorphisms = {});
@@ -0,0 +1,49 @@
+#include "FixedSizeSearch.h"
+#include "BatchKernel.h"
+#include <memory>
+
+
+template <std::size_t N>
+RangeScanner createFixedSizeScanner(const Matrix& distances, const Matrix& amounts)
+{
+    std::shared_ptr<const FixedInstance<N>> instance = std::make_shared<FixedInstance<N>>(distances, amounts);
+
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return [instance](std::vector<int>& factories, unsigned long long count, Placement& best) {
+            scanFixedAvx512<N>(*instance, factories, count, best);
+        };
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return [instance](std::vector<int>& factories, unsigned long long count, Placement& best) {
+            scanFixedAvx2<N>(*instance, factories, count, best);
+        };
+    }
+#endif
+    return [instance](std::vector<int>& factories, unsigned long long count, Placement& best) {
+        scanFixedScalar<N>(*instance, factories, count, best);
+    };
+}
+
+template <std::size_t... Sizes>
+RangeScanner selectFixedSizeScanner(const Matrix& distances, const Matrix& amounts, std::index_sequence<Sizes...>)
+{
+    RangeScanner scanner;
+    ((distances.size() == MIN_FIXED_SIZE + Sizes
+        ? (scanner = createFixedSizeScanner<MIN_FIXED_SIZE + Sizes>(distances, amounts), true)
+        : false) || ...);
+    return scanner;
+}
+
+RangeScanner getFixedSizeScanner(const Matrix& distances, const Matrix& amounts)
+{
+    if (!fitsInt32Lanes(distances, amounts)) {
+        return nullptr;
+    }
+    return selectFixedSizeScanner(
+        distances,
+        amounts,
+        std::make_index_sequence<MAX_FIXED_SIZE - MIN_FIXED_SIZE + 1>{}
+    );
+}
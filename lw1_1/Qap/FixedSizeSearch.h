@@ -0,0 +1,182 @@
+#pragma once
+#include "Qap.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+
+// Перебирает count перестановок, начиная с factories, и обновляет best.
+// По окончании factories - следующая за последней проверенной перестановка.
+using RangeScanner = std::function<void(std::vector<int>& factories, unsigned long long count, Placement& best)>;
+
+// Размеры, для которых собираются специализированные версии перебора
+const std::size_t MIN_FIXED_SIZE = 8;
+const std::size_t MAX_FIXED_SIZE = 16;
+// Строки дополнены нулями до ширины регистра AVX-512
+const std::size_t FIXED_ROW_WIDTH = 16;
+
+using FixedRow = std::array<int, FIXED_ROW_WIDTH>;
+using FixedPermutation = std::array<std::uint8_t, FIXED_ROW_WIDTH>;
+
+// Задача размера N целиком в std::array: при N <= 16 обе матрицы занимают
+// не больше 2 КБ и остаются в L1, все циклы по N разворачиваются компилятором.
+template <std::size_t N>
+struct FixedInstance
+{
+    alignas(64) std::array<FixedRow, N> distances{};
+    alignas(64) std::array<FixedRow, N> amounts{};
+
+    FixedInstance(const Matrix& distanceMatrix, const Matrix& amountMatrix)
+    {
+        for (std::size_t i = 0; i < N; i++) {
+            std::copy(distanceMatrix[i], distanceMatrix[i] + N, distances[i].begin());
+            std::copy(amountMatrix[i], amountMatrix[i] + N, amounts[i].begin());
+        }
+    }
+};
+
+template <std::size_t N, std::size_t I, std::size_t... J>
+inline Cost calculateFixedRow(const FixedInstance<N>& instance, const FixedPermutation& factories,
+                              std::index_sequence<J...>)
+{
+    const auto& amountRow = instance.amounts[factories[I]];
+    return ((instance.distances[I][J] * amountRow[factories[J]]) + ...);
+}
+
+template <std::size_t N, std::size_t... I>
+inline Cost calculateFixedPath(const FixedInstance<N>& instance, const FixedPermutation& factories,
+                               std::index_sequence<I...>)
+{
+    return (calculateFixedRow<N, I>(instance, factories, std::make_index_sequence<N>{}) + ...);
+}
+
+template <std::size_t N, typename CalculatePath>
+inline void scanFixed(
+    const FixedInstance<N>& instance,
+    std::vector<int>& factories,
+    unsigned long long count,
+    Placement& best,
+    CalculatePath calculatePath
+)
+{
+    FixedPermutation current{};
+    std::copy(factories.begin(), factories.end(), current.begin());
+
+    for (unsigned long long k = 0; k < count; k++) {
+        Cost path = calculatePath(instance, current);
+        if (path < best.cost) {
+            best.cost = path;
+            best.factories.assign(current.begin(), current.begin() + N);
+        }
+        std::next_permutation(current.begin(), current.begin() + N);
+    }
+    std::copy(current.begin(), current.begin() + N, factories.begin());
+}
+
+template <std::size_t N>
+void scanFixedScalar(const FixedInstance<N>& instance, std::vector<int>& factories,
+                     unsigned long long count, Placement& best)
+{
+    scanFixed(instance, factories, count, best, [](const FixedInstance<N>& instance, const FixedPermutation& current) {
+        return calculateFixedPath(instance, current, std::make_index_sequence<N>{});
+    });
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// Как и в calculatePathsAvx512, строка потоков переставляется в регистре
+// по индексам фабрик, но строки расстояний здесь постоянны для всего перебора.
+template <std::size_t N, std::size_t... I>
+__attribute__((target("avx512f")))
+inline Cost calculateFixedPathAvx512(const FixedInstance<N>& instance, const FixedPermutation& factories,
+                                     std::index_sequence<I...>)
+{
+    __m512i indexes = _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(factories.data())));
+    __m512i path = _mm512_setzero_si512();
+    ((path = _mm512_add_epi32(path, _mm512_mullo_epi32(
+        _mm512_load_si512(instance.distances[I].data()),
+        _mm512_permutexvar_epi32(indexes, _mm512_load_si512(instance.amounts[factories[I]].data()))))), ...);
+
+    __m512i widePath = _mm512_add_epi64(
+        _mm512_cvtepi32_epi64(_mm512_castsi512_si256(path)),
+        _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(path, 1)));
+    return _mm512_reduce_add_epi64(widePath);
+}
+
+template <std::size_t N>
+__attribute__((target("avx512f")))
+void scanFixedAvx512(const FixedInstance<N>& instance, std::vector<int>& factories,
+                     unsigned long long count, Placement& best)
+{
+    scanFixed(instance, factories, count, best,
+        [](const FixedInstance<N>& instance, const FixedPermutation& current) __attribute__((target("avx512f"))) {
+            return calculateFixedPathAvx512(instance, current, std::make_index_sequence<N>{});
+        });
+}
+
+__attribute__((target("avx2")))
+inline __m256i lookupFixedAvx2(__m256i tableLow, __m256i tableHigh, __m256i indexes)
+{
+    __m256i low = _mm256_permutevar8x32_epi32(tableLow, indexes);
+    __m256i high = _mm256_permutevar8x32_epi32(tableHigh, indexes);
+    return _mm256_blendv_epi8(low, high, _mm256_cmpgt_epi32(indexes, _mm256_set1_epi32(7)));
+}
+
+__attribute__((target("avx2")))
+inline __m256i loadFixedHalf(const int* values)
+{
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(values));
+}
+
+template <std::size_t N, std::size_t... I>
+__attribute__((target("avx2")))
+inline Cost calculateFixedPathAvx2(const FixedInstance<N>& instance, const FixedPermutation& factories,
+                                   std::index_sequence<I...>)
+{
+    const std::size_t HALF = FIXED_ROW_WIDTH / 2;
+    __m256i indexLow = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(factories.data())));
+    __m256i indexHigh = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(factories.data() + HALF)));
+    __m256i path = _mm256_setzero_si256();
+
+    auto addRow = [&](std::size_t row) __attribute__((target("avx2"))) {
+        const int* amountRow = instance.amounts[factories[row]].data();
+        __m256i tableLow = loadFixedHalf(amountRow);
+        __m256i tableHigh = loadFixedHalf(amountRow + HALF);
+        path = _mm256_add_epi32(path, _mm256_mullo_epi32(
+            loadFixedHalf(instance.distances[row].data()), lookupFixedAvx2(tableLow, tableHigh, indexLow)));
+        path = _mm256_add_epi32(path, _mm256_mullo_epi32(
+            loadFixedHalf(instance.distances[row].data() + HALF), lookupFixedAvx2(tableLow, tableHigh, indexHigh)));
+    };
+    (addRow(I), ...);
+
+    __m256i widePath = _mm256_add_epi64(
+        _mm256_cvtepi32_epi64(_mm256_castsi256_si128(path)),
+        _mm256_cvtepi32_epi64(_mm256_extracti128_si256(path, 1)));
+    alignas(32) Cost parts[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(parts), widePath);
+    return parts[0] + parts[1] + parts[2] + parts[3];
+}
+
+template <std::size_t N>
+__attribute__((target("avx2")))
+void scanFixedAvx2(const FixedInstance<N>& instance, std::vector<int>& factories,
+                   unsigned long long count, Placement& best)
+{
+    scanFixed(instance, factories, count, best,
+        [](const FixedInstance<N>& instance, const FixedPermutation& current) __attribute__((target("avx2"))) {
+            return calculateFixedPathAvx2(instance, current, std::make_index_sequence<N>{});
+        });
+}
+
+#endif
+
+// Специализированный перебор для размера задачи или nullptr, если для этого
+// размера он не собран. Строки в нём суммируются в int, поэтому при
+// !fitsInt32Lanes тоже nullptr.
+RangeScanner getFixedSizeScanner(const Matrix& distances, const Matrix& amounts);
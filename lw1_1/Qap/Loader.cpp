@@ -0,0 +1,188 @@
+#include "Loader.h"
+#include <charconv>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+MappedFile::MappedFile(const std::string& fileName)
+{
+    int descriptor = open(fileName.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("Ошибка открытия файла " + fileName);
+    }
+    struct stat status{};
+    if (fstat(descriptor, &status) != 0) {
+        close(descriptor);
+        throw std::runtime_error("Ошибка открытия файла " + fileName);
+    }
+    m_size = static_cast<std::size_t>(status.st_size);
+    if (m_size > 0) {
+        m_data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    }
+    close(descriptor);
+    if (m_data == MAP_FAILED) {
+        m_data = nullptr;
+        throw std::runtime_error("Ошибка чтения файла " + fileName);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data != nullptr) {
+        munmap(m_data, m_size);
+    }
+}
+
+std::string_view MappedFile::getContents() const
+{
+    return {static_cast<const char*>(m_data), m_size};
+}
+
+namespace
+{
+bool isSpace(char symbol)
+{
+    return symbol == ' ' || symbol == '\t' || symbol == '\r' || symbol == '\n';
+}
+
+// Разбирает очередное целое число, пропуская пробельные символы перед ним
+bool readNumber(const char*& position, const char* end, int& number)
+{
+    while (position != end && isSpace(*position)) {
+        position++;
+    }
+    if (position == end) {
+        return false;
+    }
+    auto [next, error] = std::from_chars(position, end, number);
+    if (error != std::errc()) {
+        throw std::runtime_error("Неверное число в матрице");
+    }
+    position = next;
+    return true;
+}
+
+void readMatrix(const char*& position, const char* end, Matrix& matrix)
+{
+    int* values = matrix.data();
+    std::size_t count = matrix.size() * matrix.size();
+    for (std::size_t i = 0; i < count; i++) {
+        if (!readNumber(position, end, values[i])) {
+            throw std::runtime_error("В матрице недостаточно элементов");
+        }
+    }
+}
+
+void assertNoExtraData(const char* position, const char* end)
+{
+    int number;
+    if (readNumber(position, end, number)) {
+        throw std::runtime_error("После матрицы есть лишние данные");
+    }
+}
+
+std::size_t countFirstRow(std::string_view contents)
+{
+    auto line = contents.substr(0, contents.find('\n'));
+    std::size_t count = 0;
+    bool inNumber = false;
+    for (char symbol : line) {
+        if (isSpace(symbol)) {
+            inNumber = false;
+        } else if (!inNumber) {
+            inNumber = true;
+            count++;
+        }
+    }
+    return count;
+}
+
+Matrix loadMatrix(const std::string& fileName)
+{
+    MappedFile file(fileName);
+    auto contents = file.getContents();
+    std::size_t size = countFirstRow(contents);
+    if (size == 0) {
+        throw std::runtime_error("Пустая матрица в файле " + fileName);
+    }
+
+    Matrix matrix(size);
+    const char* position = contents.data();
+    const char* end = contents.data() + contents.size();
+    readMatrix(position, end, matrix);
+    assertNoExtraData(position, end);
+    return matrix;
+}
+}
+
+Instance loadInstance(const std::string& fileName)
+{
+    MappedFile file(fileName);
+    auto contents = file.getContents();
+    const char* position = contents.data();
+    const char* end = contents.data() + contents.size();
+
+    int size;
+    if (!readNumber(position, end, size) || size <= 0) {
+        throw std::runtime_error("Неверный размер задачи в файле " + fileName);
+    }
+    Instance instance{Matrix(size), Matrix(size)};
+    readMatrix(position, end, instance.amounts);
+    readMatrix(position, end, instance.distances);
+    assertNoExtraData(position, end);
+    return instance;
+}
+
+Instance loadInstance(const std::string& distanceFileName, const std::string& amountFileName)
+{
+    Instance instance{loadMatrix(distanceFileName), loadMatrix(amountFileName)};
+    assertMatrixSizesAreEqual(instance.distances, instance.amounts);
+    return instance;
+}
+
+Instance loadInstance(const std::vector<std::string>& fileNames)
+{
+    if (fileNames.size() == 1) {
+        return loadInstance(fileNames[0]);
+    }
+    if (fileNames.size() == 2) {
+        return loadInstance(fileNames[0], fileNames[1]);
+    }
+    throw std::runtime_error("Передано неверное количество файлов");
+}
+
+void assertMatrixSizesAreEqual(
+    const Matrix& matrix1,
+    const Matrix& matrix2
+)
+{
+    if (matrix1.size() != matrix2.size()) {
+        throw std::runtime_error("Количество элементов в матрицах различно");
+    }
+}
+
+unsigned long long hashInstance(
+    const Matrix& distances,
+    const Matrix& amounts
+)
+{
+    const unsigned long long FNV_OFFSET = 14695981039346656037ull;
+    const unsigned long long FNV_PRIME = 1099511628211ull;
+
+    unsigned long long hash = FNV_OFFSET;
+    auto append = [&](unsigned long long value) {
+        for (int byte = 0; byte < 8; byte++) {
+            hash = (hash ^ ((value >> (byte * 8)) & 0xff)) * FNV_PRIME;
+        }
+    };
+    append(distances.size());
+    for (const Matrix* matrix : {&distances, &amounts}) {
+        for (std::size_t i = 0; i < matrix->size() * matrix->size(); i++) {
+            append(static_cast<unsigned int>(matrix->data()[i]));
+        }
+    }
+    return hash;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "Qap.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// Файл, отображённый в память только для чтения
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& fileName);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view getContents() const;
+
+private:
+    void* m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+struct Instance
+{
+    Matrix distances;
+    Matrix amounts;
+};
+
+// Формат QAPLIB (.dat): размер n, матрица потоков и матрица расстояний.
+// Потоки становятся amounts, расстояния - distances, поэтому напечатанная
+// расстановка, как и для двух файлов, перечисляет фабрики по позициям
+// (это обратная перестановка к решению в файлах .sln QAPLIB).
+Instance loadInstance(const std::string& fileName);
+// Расстояния и потоки в двух файлах, размер задаётся числом элементов первой строки
+Instance loadInstance(const std::string& distanceFileName, const std::string& amountFileName);
+// Один файл - формат QAPLIB, два - файлы расстояний и потоков
+Instance loadInstance(const std::vector<std::string>& fileNames);
+void assertMatrixSizesAreEqual(const Matrix& matrix1, const Matrix& matrix2);
+// Хеш FNV-1a размера и элементов обеих матриц, чтобы различать задачи
+// без сравнения самих матриц
+unsigned long long hashInstance(const Matrix& distances, const Matrix& amounts);
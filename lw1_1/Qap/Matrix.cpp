@@ -0,0 +1,19 @@
+#include "Matrix.h"
+#include <algorithm>
+
+
+Matrix::Matrix(std::size_t size, int value)
+    : m_size(size)
+    , m_data(size * size, value)
+{
+}
+
+Matrix::Matrix(std::initializer_list<std::initializer_list<int>> rows)
+    : Matrix(rows.size())
+{
+    std::size_t row = 0;
+    for (const auto& values : rows) {
+        std::copy(values.begin(), values.begin() + std::min(values.size(), m_size), (*this)[row]);
+        row++;
+    }
+}
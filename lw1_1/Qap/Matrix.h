@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <vector>
+
+
+const std::size_t MATRIX_ALIGNMENT = 64;
+
+template <typename T>
+struct AlignedAllocator
+{
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(std::size_t count)
+    {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(MATRIX_ALIGNMENT)));
+    }
+
+    void deallocate(T* pointer, std::size_t)
+    {
+        ::operator delete(pointer, std::align_val_t(MATRIX_ALIGNMENT));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U>&) const { return true; }
+};
+
+// Квадратная матрица, хранящаяся построчно в одном выровненном блоке памяти.
+// matrix[i] возвращает указатель на начало строки, поэтому запись matrix[i][j]
+// работает так же, как для вектора векторов.
+class Matrix
+{
+public:
+    Matrix() = default;
+    explicit Matrix(std::size_t size, int value = 0);
+    Matrix(std::initializer_list<std::initializer_list<int>> rows);
+
+    // Доступ к элементам определён в заголовке, чтобы встраиваться в
+    // горячие циклы оценки перестановок
+    std::size_t size() const { return m_size; }
+    int* operator[](std::size_t row) { return m_data.data() + row * m_size; }
+    const int* operator[](std::size_t row) const { return m_data.data() + row * m_size; }
+    int* data() { return m_data.data(); }
+    const int* data() const { return m_data.data(); }
+
+private:
+    std::size_t m_size = 0;
+    std::vector<int, AlignedAllocator<int>> m_data;
+};
@@ -0,0 +1,87 @@
+#include "ParallelSearch.h"
+#include "BranchAndBound.h"
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+
+const int TASKS_PER_THREAD = 16;
+
+
+void appendPrefixes(
+    std::vector<int>& prefix,
+    std::vector<bool>& used,
+    int depth,
+    std::vector<std::vector<int>>& prefixes
+)
+{
+    if (prefix.size() == static_cast<std::size_t>(depth)) {
+        prefixes.push_back(prefix);
+        return;
+    }
+    for (int factory = 0; factory < static_cast<int>(used.size()); factory++) {
+        if (used[factory]) {
+            continue;
+        }
+        used[factory] = true;
+        prefix.push_back(factory);
+        appendPrefixes(prefix, used, depth, prefixes);
+        prefix.pop_back();
+        used[factory] = false;
+    }
+}
+
+// Начала перестановок минимальной длины, которых не меньше minCount,
+// в лексикографическом порядке
+std::vector<std::vector<int>> getPrefixes(int size, int minCount)
+{
+    int depth = 0;
+    long long count = 1;
+    while (depth < size && count < minCount) {
+        count *= size - depth;
+        depth++;
+    }
+
+    std::vector<std::vector<int>> prefixes;
+    std::vector<int> prefix;
+    std::vector<bool> used(size, false);
+    appendPrefixes(prefix, used, depth, prefixes);
+    return prefixes;
+}
+
+Placement findMinPathParallel(
+    const Matrix& distances,
+    const Matrix& amounts,
+    ThreadPool& pool,
+    const Automorphisms& factoryAutomorphisms,
+    Cost upperBound
+)
+{
+    int size = static_cast<int>(distances.size());
+    auto prefixes = getPrefixes(size, pool.getThreadCount() * TASKS_PER_THREAD);
+
+    std::vector<int> identity(size);
+    std::iota(identity.begin(), identity.end(), 0);
+    std::atomic<Cost> sharedBound = std::min(calculatePath(distances, amounts, identity), upperBound);
+    auto distanceBounds = std::make_shared<const DistanceBounds>(distances);
+
+    std::vector<Placement> results(prefixes.size());
+    for (std::size_t i = 0; i < prefixes.size(); i++) {
+        pool.submit([&, i] {
+            BranchAndBound search(distances, amounts, factoryAutomorphisms, distanceBounds);
+            results[i] = search.solveSubtree(prefixes[i], sharedBound);
+        });
+    }
+    pool.wait();
+
+    // Поддеревья идут в лексикографическом порядке, поэтому при равных
+    // потоках остаётся расстановка из более раннего
+    Placement best;
+    best.cost = std::numeric_limits<Cost>::max();
+    for (const auto& result : results) {
+        if (!result.factories.empty() && result.cost < best.cost) {
+            best = result;
+        }
+    }
+    return best;
+}
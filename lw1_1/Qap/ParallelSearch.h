@@ -0,0 +1,16 @@
+#pragma once
+#include "Qap.h"
+#include "ThreadPool.h"
+#include "Symmetry.h"
+#include <limits>
+
+
+// Пространство перестановок делится на поддеревья с фиксированным началом,
+// которые обходятся методом ветвей и границ на пуле потоков с общим рекордом.
+// Результат совпадает с последовательным перебором, включая выбор
+// лексикографически меньшей расстановки при равных потоках.
+// upperBound - поток известной расстановки, как в BranchAndBound::solve.
+Placement findMinPathParallel(const Matrix& distances, const Matrix& amounts, ThreadPool& pool,
+                              const Automorphisms& factoryAutomorphisms = {},
+                              Cost upperBound = std::numeric_limits<Cost>::max());
+std::vector<std::vector<int>> getPrefixes(int size, int minCount);
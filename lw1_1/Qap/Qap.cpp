@@ -0,0 +1,93 @@
+#include "Qap.h"
+#include "RankSearch.h"
+#include <numeric>
+#include <algorithm>
+#include <limits>
+
+
+Cost calculatePath(
+    const Matrix& distances,
+    const Matrix& amounts,
+    const std::vector<int>& factories
+)
+{
+    Cost path = 0;
+    for (std::size_t i = 0; i < distances.size(); i++) {
+        for (std::size_t j = 0; j < distances.size(); j++) {
+            path += static_cast<Cost>(distances[i][j]) * amounts[factories[i]][factories[j]];
+        }
+    }
+    return path;
+}
+
+bool isPermutation(const std::vector<int>& factories, int size)
+{
+    if (size <= 0 || factories.size() != static_cast<std::size_t>(size)) {
+        return false;
+    }
+    std::vector<bool> used(size, false);
+    for (int factory : factories) {
+        if (factory < 0 || factory >= size || used[factory]) {
+            return false;
+        }
+        used[factory] = true;
+    }
+    return true;
+}
+
+Cost calculateSwapDelta(
+    const Matrix& distances,
+    const Matrix& amounts,
+    const std::vector<int>& factories,
+    int r,
+    int s
+)
+{
+    int fr = factories[r];
+    int fs = factories[s];
+    Cost delta = static_cast<Cost>(distances[r][r] - distances[s][s]) * (amounts[fs][fs] - amounts[fr][fr])
+        + static_cast<Cost>(distances[r][s] - distances[s][r]) * (amounts[fs][fr] - amounts[fr][fs]);
+
+    for (int k = 0; k < static_cast<int>(distances.size()); k++) {
+        if (k == r || k == s) {
+            continue;
+        }
+        int fk = factories[k];
+        delta += static_cast<Cost>(distances[k][r] - distances[k][s]) * (amounts[fk][fs] - amounts[fk][fr])
+            + static_cast<Cost>(distances[r][k] - distances[s][k]) * (amounts[fs][fk] - amounts[fr][fk]);
+    }
+    return delta;
+}
+
+Cost updateSwapDelta(
+    const Matrix& distances,
+    const Matrix& amounts,
+    const std::vector<int>& factories,
+    Cost delta,
+    int i,
+    int j,
+    int r,
+    int s
+)
+{
+    int fi = factories[i];
+    int fj = factories[j];
+    int fr = factories[r];
+    int fs = factories[s];
+    return delta
+        + static_cast<Cost>(distances[r][i] - distances[r][j] + distances[s][j] - distances[s][i])
+            * (amounts[fs][fi] - amounts[fs][fj] + amounts[fr][fj] - amounts[fr][fi])
+        + static_cast<Cost>(distances[i][r] - distances[j][r] + distances[j][s] - distances[i][s])
+            * (amounts[fi][fs] - amounts[fj][fs] + amounts[fj][fr] - amounts[fi][fr]);
+}
+
+Placement findMinPath(
+    const Matrix& distances,
+    const Matrix& amounts
+)
+{
+    int size = static_cast<int>(distances.size());
+    auto progress = createCheckpoint(size, 0, factorial(size));
+    findMinPathInRange(distances, amounts, progress);
+    return progress.best;
+}
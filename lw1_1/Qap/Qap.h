@@ -0,0 +1,26 @@
+#pragma once
+#include "Matrix.h"
+#include <chrono>
+#include <vector>
+
+
+using Cost = long long;
+using Clock = std::chrono::steady_clock;
+
+struct Placement
+{
+    std::vector<int> factories;
+    Cost cost = 0;
+};
+
+Cost calculatePath(const Matrix& distances, const Matrix& amounts, const std::vector<int>& factories);
+// Является ли factories перестановкой чисел 0..size-1
+bool isPermutation(const std::vector<int>& factories, int size);
+// Изменение потока при обмене фабрик на позициях r и s за O(n)
+Cost calculateSwapDelta(const Matrix& distances, const Matrix& amounts, const std::vector<int>& factories, int r, int s);
+// Пересчёт изменения потока при обмене позиций i и j за O(1) после того, как
+// в factories уже обменяли позиции r и s (i, j не совпадают с r и s).
+// delta - значение calculateSwapDelta(i, j) до этого обмена.
+Cost updateSwapDelta(const Matrix& distances, const Matrix& amounts, const std::vector<int>& factories,
+                     Cost delta, int i, int j, int r, int s);
+Placement findMinPath(const Matrix& distances, const Matrix& amounts);
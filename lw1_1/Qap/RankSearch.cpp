@@ -0,0 +1,221 @@
+#include "RankSearch.h"
+#include "BatchKernel.h"
+#include "FixedSizeSearch.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+
+const Rank PERMUTATIONS_PER_CLOCK_CHECK = 1 << 16;
+
+
+Rank factorial(int size)
+{
+    Rank result = 1;
+    for (int i = 2; i <= size; i++) {
+        if (result > std::numeric_limits<Rank>::max() / i) {
+            return std::numeric_limits<Rank>::max();
+        }
+        result *= i;
+    }
+    return result;
+}
+
+Rank rankPermutation(const std::vector<int>& factories)
+{
+    int size = static_cast<int>(factories.size());
+    Rank rank = 0;
+    for (int i = 0; i < size; i++) {
+        int smaller = 0;
+        for (int j = i + 1; j < size; j++) {
+            if (factories[j] < factories[i]) {
+                smaller++;
+            }
+        }
+        rank += smaller * factorial(size - 1 - i);
+    }
+    return rank;
+}
+
+std::vector<int> unrankPermutation(Rank rank, int size)
+{
+    std::vector<int> remaining(size);
+    for (int i = 0; i < size; i++) {
+        remaining[i] = i;
+    }
+    std::vector<int> factories;
+    for (int i = 0; i < size; i++) {
+        Rank block = factorial(size - 1 - i);
+        auto index = static_cast<int>(rank / block);
+        rank %= block;
+        factories.push_back(remaining[index]);
+        remaining.erase(remaining.begin() + index);
+    }
+    return factories;
+}
+
+Checkpoint createCheckpoint(int size, Rank first, Rank last)
+{
+    if (first >= last || last > factorial(size)) {
+        throw std::runtime_error("Неверный диапазон номеров перестановок");
+    }
+    Checkpoint checkpoint;
+    checkpoint.size = size;
+    checkpoint.rank = first;
+    checkpoint.end = last;
+    checkpoint.best.cost = std::numeric_limits<Cost>::max();
+    return checkpoint;
+}
+
+void saveCheckpoint(const std::string& fileName, const Checkpoint& checkpoint)
+{
+    // Запись через временный файл, чтобы прерванное сохранение не испортило прежнее
+    std::string temporaryName = fileName + ".tmp";
+    {
+        std::ofstream file(temporaryName);
+        file << "size " << checkpoint.size << std::endl
+             << "rank " << checkpoint.rank << std::endl
+             << "end " << checkpoint.end << std::endl
+             << "elapsed " << checkpoint.elapsed << std::endl
+             << "cost " << checkpoint.best.cost << std::endl
+             << "factories";
+        for (int factory : checkpoint.best.factories) {
+            file << ' ' << factory;
+        }
+        file << std::endl;
+        if (!file) {
+            throw std::runtime_error("Ошибка записи файла " + temporaryName);
+        }
+    }
+    if (std::rename(temporaryName.c_str(), fileName.c_str()) != 0) {
+        throw std::runtime_error("Ошибка записи файла " + fileName);
+    }
+}
+
+Checkpoint loadCheckpoint(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+    if (!file.is_open()) {
+        throw std::runtime_error("Ошибка открытия файла " + fileName);
+    }
+
+    Checkpoint checkpoint;
+    std::string key;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        iss >> key;
+        if (key == "size") {
+            iss >> checkpoint.size;
+        } else if (key == "rank") {
+            iss >> checkpoint.rank;
+        } else if (key == "end") {
+            iss >> checkpoint.end;
+        } else if (key == "elapsed") {
+            iss >> checkpoint.elapsed;
+        } else if (key == "cost") {
+            iss >> checkpoint.best.cost;
+        } else if (key == "factories") {
+            int factory;
+            while (iss >> factory) {
+                checkpoint.best.factories.push_back(factory);
+            }
+        }
+        if (iss.fail() && !iss.eof()) {
+            throw std::runtime_error("Неверная строка в файле " + fileName + ": " + line);
+        }
+    }
+    if (checkpoint.size <= 0 || checkpoint.rank > checkpoint.end
+        || checkpoint.end > factorial(checkpoint.size)) {
+        throw std::runtime_error("Неверное состояние перебора в файле " + fileName);
+    }
+    if (!checkpoint.best.factories.empty() && !isPermutation(checkpoint.best.factories, checkpoint.size)) {
+        throw std::runtime_error("Неверная расстановка в файле " + fileName);
+    }
+    return checkpoint;
+}
+
+void restoreCheckpoint(Checkpoint& checkpoint, const Matrix& distances, const Matrix& amounts)
+{
+    if (static_cast<std::size_t>(checkpoint.size) != distances.size()) {
+        throw std::runtime_error("Контрольная точка сохранена для задачи другого размера");
+    }
+    checkpoint.best.cost = checkpoint.best.factories.empty()
+        ? std::numeric_limits<Cost>::max()
+        : calculatePath(distances, amounts, checkpoint.best.factories);
+}
+
+RangeScanner getBatchScanner(const Matrix& distances, const Matrix& amounts)
+{
+    int size = static_cast<int>(distances.size());
+    BatchKernel calculatePaths = selectBatchKernel(distances, amounts);
+    auto batch = std::make_shared<std::vector<int, AlignedAllocator<int>>>(size * BATCH_SIZE, 0);
+
+    return [&distances, &amounts, size, calculatePaths, batch](
+        std::vector<int>& factories,
+        Rank count,
+        Placement& best
+    ) {
+        Cost costs[BATCH_SIZE];
+        while (count > 0) {
+            int laneCount = 0;
+            for (; laneCount < BATCH_SIZE && count > 0; laneCount++, count--) {
+                std::copy(factories.begin(), factories.end(), batch->begin() + laneCount * size);
+                std::next_permutation(factories.begin(), factories.end());
+            }
+            calculatePaths(distances, amounts, batch->data(), costs);
+
+            for (int lane = 0; lane < laneCount; lane++) {
+                if (costs[lane] < best.cost) {
+                    best.cost = costs[lane];
+                    best.factories.assign(
+                        batch->begin() + lane * size,
+                        batch->begin() + (lane + 1) * size
+                    );
+                }
+            }
+        }
+    };
+}
+
+void findMinPathInRange(
+    const Matrix& distances,
+    const Matrix& amounts,
+    Checkpoint& progress,
+    double interval,
+    const std::function<void(const Checkpoint&)>& onCheckpoint
+)
+{
+    RangeScanner scan = getFixedSizeScanner(distances, amounts);
+    if (!scan) {
+        scan = getBatchScanner(distances, amounts);
+    }
+
+    auto startTime = Clock::now();
+    auto lastCheckpoint = startTime;
+    double startElapsed = progress.elapsed;
+    auto saveProgress = [&](Clock::time_point now) {
+        progress.elapsed = startElapsed + std::chrono::duration<double>(now - startTime).count();
+        lastCheckpoint = now;
+        if (onCheckpoint) {
+            onCheckpoint(progress);
+        }
+    };
+
+    std::vector<int> factories = unrankPermutation(progress.rank, progress.size);
+    while (progress.rank < progress.end) {
+        Rank count = std::min(PERMUTATIONS_PER_CLOCK_CHECK, progress.end - progress.rank);
+        scan(factories, count, progress.best);
+        progress.rank += count;
+
+        auto now = Clock::now();
+        if (interval > 0 && std::chrono::duration<double>(now - lastCheckpoint).count() >= interval) {
+            saveProgress(now);
+        }
+    }
+    saveProgress(Clock::now());
+}
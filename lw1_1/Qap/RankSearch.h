@@ -0,0 +1,42 @@
+#pragma once
+#include "Qap.h"
+#include <functional>
+#include <string>
+
+
+// Номер перестановки в лексикографическом порядке (по коду Лемера).
+// 20! ещё помещается в 64 бита, для больших размеров номера насыщаются.
+using Rank = unsigned long long;
+
+Rank factorial(int size);
+Rank rankPermutation(const std::vector<int>& factories);
+std::vector<int> unrankPermutation(Rank rank, int size);
+
+// Состояние перебора диапазона номеров [rank, end)
+struct Checkpoint
+{
+    int size = 0;
+    Rank rank = 0;
+    Rank end = 0;
+    Placement best;
+    double elapsed = 0;
+};
+
+Checkpoint createCheckpoint(int size, Rank first, Rank last);
+void saveCheckpoint(const std::string& fileName, const Checkpoint& checkpoint);
+// Лучшая расстановка в файле - перестановка размера задачи или пусто, если
+// её ещё не было
+Checkpoint loadCheckpoint(const std::string& fileName);
+// Сверяет размер контрольной точки с задачей и пересчитывает поток лучшей
+// расстановки по текущим матрицам: сохранённому потоку не доверяем
+void restoreCheckpoint(Checkpoint& checkpoint, const Matrix& distances, const Matrix& amounts);
+
+// Полный перебор оставшейся части диапазона из progress. Раз в interval секунд
+// и по окончании progress обновляется и передаётся в onCheckpoint.
+void findMinPathInRange(
+    const Matrix& distances,
+    const Matrix& amounts,
+    Checkpoint& progress,
+    double interval = 0,
+    const std::function<void(const Checkpoint&)>& onCheckpoint = nullptr
+);
@@ -0,0 +1,87 @@
+#include "SparseFlows.h"
+
+
+bool isSparse(const Matrix& amounts)
+{
+    std::size_t elementCount = amounts.size() * amounts.size();
+    std::size_t nonZeroCount = 0;
+    for (std::size_t i = 0; i < elementCount; i++) {
+        nonZeroCount += amounts.data()[i] != 0;
+    }
+    return nonZeroCount <= SPARSE_FLOW_MAX_DENSITY * elementCount;
+}
+
+SparseFlows::SparseFlows(const Matrix& amounts)
+{
+    int size = static_cast<int>(amounts.size());
+    m_outgoingOffsets.push_back(0);
+    m_incomingOffsets.push_back(0);
+    for (int f = 0; f < size; f++) {
+        for (int g = 0; g < size; g++) {
+            if (amounts[f][g] != 0) {
+                m_outgoing.push_back({g, amounts[f][g]});
+            }
+            if (amounts[g][f] != 0) {
+                m_incoming.push_back({g, amounts[g][f]});
+            }
+        }
+        m_outgoingOffsets.push_back(static_cast<int>(m_outgoing.size()));
+        m_incomingOffsets.push_back(static_cast<int>(m_incoming.size()));
+    }
+}
+
+Cost SparseFlows::calculatePath(const Matrix& distances, const std::vector<int>& locations) const
+{
+    Cost path = 0;
+    for (std::size_t f = 0; f < locations.size(); f++) {
+        const int* row = distances[locations[f]];
+        for (int k = m_outgoingOffsets[f]; k < m_outgoingOffsets[f + 1]; k++) {
+            path += static_cast<Cost>(row[locations[m_outgoing[k].factory]]) * m_outgoing[k].amount;
+        }
+    }
+    return path;
+}
+
+// Потоки между самими фабриками fr и fs учитываются только среди исходящих,
+// чтобы не сосчитать их дважды
+Cost SparseFlows::calculateSwapDelta(
+    const Matrix& distances,
+    const std::vector<int>& factories,
+    const std::vector<int>& locations,
+    int r,
+    int s
+) const
+{
+    int fr = factories[r];
+    int fs = factories[s];
+    auto locationAfterSwap = [&](int factory) {
+        return factory == fr ? s : factory == fs ? r : locations[factory];
+    };
+
+    Cost delta = 0;
+    for (int k = m_outgoingOffsets[fr]; k < m_outgoingOffsets[fr + 1]; k++) {
+        const auto& flow = m_outgoing[k];
+        delta += static_cast<Cost>(distances[s][locationAfterSwap(flow.factory)]
+            - distances[r][locations[flow.factory]]) * flow.amount;
+    }
+    for (int k = m_outgoingOffsets[fs]; k < m_outgoingOffsets[fs + 1]; k++) {
+        const auto& flow = m_outgoing[k];
+        delta += static_cast<Cost>(distances[r][locationAfterSwap(flow.factory)]
+            - distances[s][locations[flow.factory]]) * flow.amount;
+    }
+    for (int k = m_incomingOffsets[fr]; k < m_incomingOffsets[fr + 1]; k++) {
+        const auto& flow = m_incoming[k];
+        if (flow.factory != fr && flow.factory != fs) {
+            int location = locations[flow.factory];
+            delta += static_cast<Cost>(distances[location][s] - distances[location][r]) * flow.amount;
+        }
+    }
+    for (int k = m_incomingOffsets[fs]; k < m_incomingOffsets[fs + 1]; k++) {
+        const auto& flow = m_incoming[k];
+        if (flow.factory != fr && flow.factory != fs) {
+            int location = locations[flow.factory];
+            delta += static_cast<Cost>(distances[location][r] - distances[location][s]) * flow.amount;
+        }
+    }
+    return delta;
+}
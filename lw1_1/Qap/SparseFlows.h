@@ -0,0 +1,37 @@
+#pragma once
+#include "Qap.h"
+
+
+// Доля ненулевых потоков, до которой выгоднее перебирать только их. Используется
+// локальными поисками (обмены, поиск с запретами); в полном переборе время
+// уходит на обход перестановок, и разреженный подсчёт не быстрее плотного.
+const double SPARSE_FLOW_MAX_DENSITY = 0.25;
+
+bool isSparse(const Matrix& amounts);
+
+// Ненулевые потоки в формате CSR: исходящие из фабрики f и входящие в неё.
+// Поток расстановки и его изменение при обмене считаются только по ним,
+// поэтому нужны позиции фабрик locations - перестановка, обратная factories.
+class SparseFlows
+{
+public:
+    explicit SparseFlows(const Matrix& amounts);
+
+    Cost calculatePath(const Matrix& distances, const std::vector<int>& locations) const;
+    // То же, что ::calculateSwapDelta, за время, пропорциональное числу
+    // ненулевых потоков фабрик на позициях r и s
+    Cost calculateSwapDelta(const Matrix& distances, const std::vector<int>& factories,
+                            const std::vector<int>& locations, int r, int s) const;
+
+private:
+    struct Flow
+    {
+        int factory;
+        int amount;
+    };
+
+    std::vector<int> m_outgoingOffsets;
+    std::vector<Flow> m_outgoing;
+    std::vector<int> m_incomingOffsets;
+    std::vector<Flow> m_incoming;
+};
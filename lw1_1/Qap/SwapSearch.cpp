@@ -0,0 +1,52 @@
+#include "SwapSearch.h"
+#include "SparseFlows.h"
+#include <numeric>
+#include <algorithm>
+#include <optional>
+
+
+Placement findMinPathBySwaps(
+    const Matrix& distances,
+    const Matrix& amounts
+)
+{
+    int size = static_cast<int>(distances.size());
+    std::vector<int> factories(size);
+    std::iota(factories.begin(), factories.end(), 0);
+
+    std::vector<int> locations = factories;
+    std::optional<SparseFlows> sparseFlows;
+    if (isSparse(amounts)) {
+        sparseFlows.emplace(amounts);
+    }
+
+    Cost currentPath = calculatePath(distances, amounts, factories);
+    Placement best{factories, currentPath};
+
+    std::vector<int> counters(size, 0);
+    int i = 1;
+    while (i < size) {
+        if (counters[i] >= i) {
+            counters[i] = 0;
+            i++;
+            continue;
+        }
+        int j = i % 2 == 0 ? 0 : counters[i];
+        if (sparseFlows) {
+            currentPath += sparseFlows->calculateSwapDelta(distances, factories, locations, j, i);
+            std::swap(locations[factories[j]], locations[factories[i]]);
+        } else {
+            currentPath += calculateSwapDelta(distances, amounts, factories, j, i);
+        }
+        std::swap(factories[j], factories[i]);
+
+        if (currentPath < best.cost
+            || (currentPath == best.cost && factories < best.factories)) {
+            best.cost = currentPath;
+            best.factories = factories;
+        }
+        counters[i]++;
+        i = 1;
+    }
+    return best;
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include "Qap.h"
+
+
+// Полный перебор в порядке алгоритма Хипа: соседние перестановки отличаются
+// одним обменом, поэтому поток пересчитывается за O(n) вместо O(n^2).
+// При равных потоках выбирается лексикографически меньшая расстановка,
+// как и в findMinPath. Для разреженной матрицы потоков изменение при обмене
+// считается только по ненулевым потокам (SparseFlows).
+Placement findMinPathBySwaps(const Matrix& distances, const Matrix& amounts);
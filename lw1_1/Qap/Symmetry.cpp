@@ -0,0 +1,142 @@
+#include "Symmetry.h"
+#include <algorithm>
+
+
+struct AutomorphismSearch
+{
+    const Matrix& matrix;
+    int size;
+    // Вершины с разными инвариантами не могут переходить друг в друга
+    std::vector<int> classes;
+    std::vector<int> mapping;
+    std::vector<bool> used;
+    Automorphisms found;
+    long long steps = 0;
+};
+
+// Номер класса для каждой строки: диагональ и отсортированные строка и столбец
+std::vector<int> getInvariantClasses(const Matrix& matrix)
+{
+    int size = static_cast<int>(matrix.size());
+    std::vector<std::vector<int>> invariants(size);
+    for (int i = 0; i < size; i++) {
+        std::vector<int> row(matrix[i], matrix[i] + size);
+        std::vector<int> column(size);
+        for (int j = 0; j < size; j++) {
+            column[j] = matrix[j][i];
+        }
+        std::sort(row.begin(), row.end());
+        std::sort(column.begin(), column.end());
+
+        invariants[i].push_back(matrix[i][i]);
+        invariants[i].insert(invariants[i].end(), row.begin(), row.end());
+        invariants[i].insert(invariants[i].end(), column.begin(), column.end());
+    }
+
+    auto sorted = invariants;
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    std::vector<int> classes(size);
+    for (int i = 0; i < size; i++) {
+        classes[i] = static_cast<int>(std::lower_bound(sorted.begin(), sorted.end(), invariants[i]) - sorted.begin());
+    }
+    return classes;
+}
+
+bool isConsistent(const AutomorphismSearch& search, int vertex, int image)
+{
+    const auto& matrix = search.matrix;
+    if (matrix[image][image] != matrix[vertex][vertex]) {
+        return false;
+    }
+    for (int j = 0; j < vertex; j++) {
+        int other = search.mapping[j];
+        if (matrix[image][other] != matrix[vertex][j] || matrix[other][image] != matrix[j][vertex]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void extendAutomorphism(AutomorphismSearch& search, int vertex, bool isIdentity)
+{
+    if (search.found.size() >= MAX_AUTOMORPHISMS || search.steps >= MAX_AUTOMORPHISM_SEARCH_STEPS) {
+        return;
+    }
+    search.steps++;
+    if (vertex == search.size) {
+        if (!isIdentity) {
+            search.found.push_back(search.mapping);
+        }
+        return;
+    }
+    for (int image = 0; image < search.size; image++) {
+        if (search.used[image] || search.classes[image] != search.classes[vertex]
+            || !isConsistent(search, vertex, image)) {
+            continue;
+        }
+        search.used[image] = true;
+        search.mapping[vertex] = image;
+        extendAutomorphism(search, vertex + 1, isIdentity && image == vertex);
+        search.used[image] = false;
+    }
+}
+
+bool isSymmetric(const Matrix& matrix)
+{
+    for (std::size_t i = 0; i < matrix.size(); i++) {
+        for (std::size_t j = i + 1; j < matrix.size(); j++) {
+            if (matrix[i][j] != matrix[j][i]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+Automorphisms findAutomorphisms(const Matrix& matrix)
+{
+    int size = static_cast<int>(matrix.size());
+    AutomorphismSearch search{matrix, size, getInvariantClasses(matrix), {}, {}, {}, 0};
+    search.mapping.resize(size);
+    search.used.resize(size, false);
+    extendAutomorphism(search, 0, true);
+    return search.found;
+}
+
+SymmetryInfo detectSymmetry(const Matrix& distances, const Matrix& amounts, bool isTransposable)
+{
+    SymmetryInfo symmetry;
+    symmetry.factoryAutomorphisms = findAutomorphisms(amounts);
+    if (isTransposable) {
+        symmetry.locationAutomorphisms = findAutomorphisms(distances);
+    }
+    return symmetry;
+}
+
+std::vector<int> invertPermutation(const std::vector<int>& permutation)
+{
+    std::vector<int> inverse(permutation.size());
+    for (int i = 0; i < static_cast<int>(permutation.size()); i++) {
+        inverse[permutation[i]] = i;
+    }
+    return inverse;
+}
+
+Placement solveReduced(
+    const Matrix& distances,
+    const Matrix& amounts,
+    const SymmetryInfo& symmetry,
+    const ReducedSolver& solve
+)
+{
+    if (symmetry.locationAutomorphisms.size() <= symmetry.factoryAutomorphisms.size()) {
+        return solve(distances, amounts, symmetry.factoryAutomorphisms);
+    }
+    // Поток p в исходной задаче равен потоку обратной перестановки в задаче
+    // с переставленными матрицами, где симметрии позиций становятся симметриями фабрик
+    auto placement = solve(amounts, distances, symmetry.locationAutomorphisms);
+    placement.factories = invertPermutation(placement.factories);
+    return placement;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "Qap.h"
+#include <functional>
+
+
+// Перестановки t, для которых matrix[t[i]][t[j]] == matrix[i][j]
+using Automorphisms = std::vector<std::vector<int>>;
+
+// Поиск автоморфизмов ограничен, список может быть неполным. Отсечение по
+// любому подмножеству автоморфизмов остаётся корректным.
+const int MAX_AUTOMORPHISMS = 4096;
+const long long MAX_AUTOMORPHISM_SEARCH_STEPS = 1000000;
+
+struct SymmetryInfo
+{
+    // Перестановки фабрик, сохраняющие потоки: поток расстановки p равен потоку t(p)
+    Automorphisms factoryAutomorphisms;
+    // Перестановки позиций, сохраняющие расстояния: поток p равен потоку p(t).
+    // Ищутся только при разрешённом транспонировании.
+    Automorphisms locationAutomorphisms;
+};
+
+bool isSymmetric(const Matrix& matrix);
+// Нетождественные автоморфизмы матрицы, не больше MAX_AUTOMORPHISMS
+Automorphisms findAutomorphisms(const Matrix& matrix);
+SymmetryInfo detectSymmetry(const Matrix& distances, const Matrix& amounts, bool isTransposable = false);
+std::vector<int> invertPermutation(const std::vector<int>& permutation);
+
+using ReducedSolver = std::function<Placement(const Matrix& distances, const Matrix& amounts,
+                                              const Automorphisms& factoryAutomorphisms)>;
+
+// Запускает solve так, чтобы перебирались только канонические представители.
+// Симметрии фабрик отсекаются при ветвлении напрямую, и тогда результат
+// совпадает с перебором без симметрий. Если симметрий позиций найдено больше
+// (они есть, только если detectSymmetry разрешили транспонирование), задача
+// решается транспонированной (позиции и фабрики меняются ролями, расстановка
+// обращается), и при равных потоках может быть выбрана другая оптимальная
+// расстановка.
+Placement solveReduced(
+    const Matrix& distances,
+    const Matrix& amounts,
+    const SymmetryInfo& symmetry,
+    const ReducedSolver& solve
+);
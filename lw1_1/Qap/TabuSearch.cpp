@@ -0,0 +1,178 @@
+#include "TabuSearch.h"
+#include <numeric>
+#include <algorithm>
+#include <limits>
+
+
+BestPlacement::BestPlacement(std::function<void(const Placement&)> onImprove)
+    : m_onImprove(std::move(onImprove))
+{
+    m_placement.cost = std::numeric_limits<Cost>::max();
+}
+
+bool BestPlacement::update(const std::vector<int>& factories, Cost cost)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (cost >= m_placement.cost) {
+        return false;
+    }
+    m_placement.factories = factories;
+    m_placement.cost = cost;
+    if (m_onImprove) {
+        m_onImprove(m_placement);
+    }
+    return true;
+}
+
+Placement BestPlacement::get() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_placement;
+}
+
+TabuSearch::TabuSearch(const Matrix& distances, const Matrix& amounts, unsigned seed)
+    : m_distances(distances)
+    , m_amounts(amounts)
+    , m_size(static_cast<int>(distances.size()))
+    , m_generator(seed)
+    , m_factories(m_size)
+    , m_locations(m_size)
+    , m_deltas(m_size * m_size, 0)
+    , m_tabu(m_size * m_size, 0)
+    , m_tabuDuration(8 * m_size)
+    , m_aspiration(5LL * m_size * m_size)
+{
+    if (isSparse(amounts)) {
+        m_sparseFlows.emplace(amounts);
+    }
+}
+
+void TabuSearch::run(Clock::time_point deadline, BestPlacement& best)
+{
+    initialize();
+    Cost bestCost = m_cost;
+    best.update(m_factories, m_cost);
+    if (m_size < 2) {
+        return;
+    }
+
+    for (long long iteration = 1; Clock::now() < deadline; iteration++) {
+        int r;
+        int s;
+        if (!findMove(iteration, bestCost, r, s)) {
+            continue;
+        }
+        makeMove(iteration, r, s);
+        if (m_cost < bestCost) {
+            bestCost = m_cost;
+            best.update(m_factories, m_cost);
+        }
+    }
+}
+
+void TabuSearch::initialize()
+{
+    std::iota(m_factories.begin(), m_factories.end(), 0);
+    std::shuffle(m_factories.begin(), m_factories.end(), m_generator);
+    for (int location = 0; location < m_size; location++) {
+        m_locations[m_factories[location]] = location;
+    }
+    m_cost = m_sparseFlows ? m_sparseFlows->calculatePath(m_distances, m_locations)
+                           : calculatePath(m_distances, m_amounts, m_factories);
+
+    for (int i = 0; i < m_size; i++) {
+        for (int j = i + 1; j < m_size; j++) {
+            m_deltas[i * m_size + j] = calculateSwapDelta(i, j);
+        }
+    }
+    std::fill(m_tabu.begin(), m_tabu.end(), 0);
+}
+
+bool TabuSearch::findMove(long long iteration, Cost bestCost, int& r, int& s)
+{
+    Cost minDelta = std::numeric_limits<Cost>::max();
+    bool alreadyAspired = false;
+    bool found = false;
+
+    for (int i = 0; i < m_size; i++) {
+        for (int j = i + 1; j < m_size; j++) {
+            Cost delta = m_deltas[i * m_size + j];
+            long long tabuI = m_tabu[i * m_size + m_factories[j]];
+            long long tabuJ = m_tabu[j * m_size + m_factories[i]];
+
+            bool authorized = tabuI < iteration || tabuJ < iteration;
+            bool aspired = tabuI < iteration - m_aspiration
+                || tabuJ < iteration - m_aspiration
+                || m_cost + delta < bestCost;
+
+            if ((aspired && !alreadyAspired)
+                || (aspired && alreadyAspired && delta < minDelta)
+                || (!aspired && !alreadyAspired && authorized && delta < minDelta)) {
+                r = i;
+                s = j;
+                minDelta = delta;
+                found = true;
+                alreadyAspired = alreadyAspired || aspired;
+            }
+        }
+    }
+    return found;
+}
+
+void TabuSearch::makeMove(long long iteration, int r, int s)
+{
+    std::swap(m_locations[m_factories[r]], m_locations[m_factories[s]]);
+    std::swap(m_factories[r], m_factories[s]);
+    m_cost += m_deltas[r * m_size + s];
+
+    // Срок запрета выбирается случайно, кубическое распределение чаще даёт короткие сроки
+    std::uniform_real_distribution<double> uniform(0, 1);
+    auto drawDuration = [&] {
+        double value = uniform(m_generator);
+        return static_cast<long long>(value * value * value * m_tabuDuration);
+    };
+    m_tabu[r * m_size + m_factories[s]] = iteration + drawDuration();
+    m_tabu[s * m_size + m_factories[r]] = iteration + drawDuration();
+
+    for (int i = 0; i < m_size; i++) {
+        for (int j = i + 1; j < m_size; j++) {
+            Cost& delta = m_deltas[i * m_size + j];
+            if (i == r || i == s || j == r || j == s) {
+                delta = calculateSwapDelta(i, j);
+            } else {
+                delta = updateSwapDelta(m_distances, m_amounts, m_factories, delta, i, j, r, s);
+            }
+        }
+    }
+}
+
+Cost TabuSearch::calculateSwapDelta(int r, int s) const
+{
+    if (m_sparseFlows) {
+        return m_sparseFlows->calculateSwapDelta(m_distances, m_factories, m_locations, r, s);
+    }
+    return ::calculateSwapDelta(m_distances, m_amounts, m_factories, r, s);
+}
+
+Placement findMinPathHeuristic(
+    const Matrix& distances,
+    const Matrix& amounts,
+    double timeLimit,
+    ThreadPool& pool,
+    std::function<void(const Placement&)> onImprove
+)
+{
+    auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(timeLimit));
+    BestPlacement best(std::move(onImprove));
+
+    std::random_device device;
+    for (int i = 0; i < pool.getThreadCount(); i++) {
+        unsigned seed = device() + i;
+        pool.submit([&, seed] {
+            TabuSearch(distances, amounts, seed).run(deadline, best);
+        });
+    }
+    pool.wait();
+    return best.get();
+}
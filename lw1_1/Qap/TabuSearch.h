@@ -0,0 +1,68 @@
+#pragma once
+#include "Qap.h"
+#include "ThreadPool.h"
+#include "SparseFlows.h"
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <random>
+
+
+// Общий для нескольких потоков рекорд. При каждом улучшении вызывается onImprove.
+class BestPlacement
+{
+public:
+    explicit BestPlacement(std::function<void(const Placement&)> onImprove = nullptr);
+
+    bool update(const std::vector<int>& factories, Cost cost);
+    Placement get() const;
+
+private:
+    mutable std::mutex m_mutex;
+    Placement m_placement;
+    std::function<void(const Placement&)> m_onImprove;
+};
+
+// Устойчивый поиск с запретами (Taillard, robust tabu search).
+// Окрестность - все обмены двух позиций, изменения потока хранятся в матрице
+// и после каждого хода пересчитываются за O(1), а для затронутых позиций за O(n)
+// или, если потоки разрежены, по ненулевым потокам двух фабрик.
+class TabuSearch
+{
+public:
+    TabuSearch(const Matrix& distances, const Matrix& amounts, unsigned seed);
+    void run(Clock::time_point deadline, BestPlacement& best);
+
+private:
+    void initialize();
+    bool findMove(long long iteration, Cost bestCost, int& r, int& s);
+    void makeMove(long long iteration, int r, int s);
+    Cost calculateSwapDelta(int r, int s) const;
+
+    const Matrix& m_distances;
+    const Matrix& m_amounts;
+    int m_size;
+    std::mt19937 m_generator;
+
+    std::optional<SparseFlows> m_sparseFlows;
+    std::vector<int> m_factories;
+    std::vector<int> m_locations;
+    Cost m_cost = 0;
+    std::vector<Cost> m_deltas;
+    // m_tabu[location * n + factory] - итерация, до которой фабрику нельзя
+    // возвращать на эту позицию
+    std::vector<long long> m_tabu;
+    long long m_tabuDuration;
+    long long m_aspiration;
+};
+
+// Запускает threadCount независимых поисков с разными начальными значениями
+// генератора до истечения timeLimit секунд и возвращает лучшую расстановку
+Placement findMinPathHeuristic(
+    const Matrix& distances,
+    const Matrix& amounts,
+    double timeLimit,
+    ThreadPool& pool,
+    std::function<void(const Placement&)> onImprove
+);
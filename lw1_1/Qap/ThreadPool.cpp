@@ -0,0 +1,121 @@
+#include "ThreadPool.h"
+
+
+namespace
+{
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local int currentWorker = -1;
+}
+
+
+ThreadPool::ThreadPool(int threadCount)
+{
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    for (int i = 0; i < threadCount; i++) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (int i = 0; i < threadCount; i++) {
+        m_threads.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_hasWork.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    // Задачи, порождённые внутри пула, остаются в очереди своего потока
+    int index = currentPool == this
+        ? currentWorker
+        : static_cast<int>(m_nextQueue++ % m_queues.size());
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queuedCount++;
+        m_pendingCount++;
+    }
+    m_hasWork.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pendingCount == 0; });
+}
+
+int ThreadPool::getThreadCount() const
+{
+    return static_cast<int>(m_threads.size());
+}
+
+void ThreadPool::run(int index)
+{
+    currentPool = this;
+    currentWorker = index;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_hasWork.wait(lock, [this] { return m_stopping || m_queuedCount > 0; });
+            if (m_queuedCount == 0) {
+                return;
+            }
+            // Счётчик гарантирует, что в какой-то из очередей есть задача для этого потока
+            m_queuedCount--;
+        }
+
+        std::function<void()> task;
+        while (!popTask(index, task)) {
+            std::this_thread::yield();
+        }
+        task();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pendingCount == 0) {
+            m_done.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::popTask(int index, std::function<void()>& task)
+{
+    {
+        auto& own = *m_queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    for (std::size_t offset = 1; offset < m_queues.size(); offset++) {
+        auto& victim = *m_queues[(index + offset) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+int getDefaultThreadCount()
+{
+    unsigned count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : static_cast<int>(count);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Пул потоков с воровством задач: у каждого потока своя очередь, задачи
+// берутся из её начала, а простаивающий поток забирает задачи с конца чужих.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    void submit(std::function<void()> task);
+    void wait();
+    int getThreadCount() const;
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void run(int index);
+    bool popTask(int index, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_hasWork;
+    std::condition_variable m_done;
+    int m_queuedCount = 0;
+    int m_pendingCount = 0;
+    bool m_stopping = false;
+    std::atomic<unsigned> m_nextQueue = 0;
+};
+
+int getDefaultThreadCount();
@@ -0,0 +1,77 @@
+#include "WarmStart.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+
+void saveSolution(const std::string& fileName, const SavedSolution& solution)
+{
+    // Запись через временный файл, как у контрольных точек перебора
+    std::string temporaryName = fileName + ".tmp";
+    {
+        std::ofstream file(temporaryName);
+        file << "size " << solution.size << std::endl
+             << "hash " << solution.instanceHash << std::endl
+             << "cost " << solution.placement.cost << std::endl
+             << "factories";
+        for (int factory : solution.placement.factories) {
+            file << ' ' << factory;
+        }
+        file << std::endl;
+        if (!file) {
+            throw std::runtime_error("Ошибка записи файла " + temporaryName);
+        }
+    }
+    if (std::rename(temporaryName.c_str(), fileName.c_str()) != 0) {
+        throw std::runtime_error("Ошибка записи файла " + fileName);
+    }
+}
+
+SavedSolution loadSolution(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+    if (!file.is_open()) {
+        throw std::runtime_error("Ошибка открытия файла " + fileName);
+    }
+
+    SavedSolution solution;
+    std::string key;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        iss >> key;
+        if (key == "size") {
+            iss >> solution.size;
+        } else if (key == "hash") {
+            iss >> solution.instanceHash;
+        } else if (key == "cost") {
+            iss >> solution.placement.cost;
+        } else if (key == "factories") {
+            int factory;
+            while (iss >> factory) {
+                solution.placement.factories.push_back(factory);
+            }
+        }
+        if (iss.fail() && !iss.eof()) {
+            throw std::runtime_error("Неверная строка в файле " + fileName + ": " + line);
+        }
+    }
+
+    if (!isPermutation(solution.placement.factories, solution.size)) {
+        throw std::runtime_error("Неверная расстановка в файле " + fileName);
+    }
+    return solution;
+}
+
+Cost getUpperBound(
+    const SavedSolution& solution,
+    const Matrix& distances,
+    const Matrix& amounts
+)
+{
+    if (static_cast<std::size_t>(solution.size) != distances.size()) {
+        throw std::runtime_error("Решение сохранено для задачи другого размера");
+    }
+    return calculatePath(distances, amounts, solution.placement.factories);
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "Qap.h"
+#include <string>
+
+
+// Решение, сохранённое прошлым запуском. По хешу задачи (hashInstance)
+// решение той же задачи отличается от решения с изменившимися потоками.
+struct SavedSolution
+{
+    int size = 0;
+    unsigned long long instanceHash = 0;
+    Placement placement;
+};
+
+void saveSolution(const std::string& fileName, const SavedSolution& solution);
+SavedSolution loadSolution(const std::string& fileName);
+// Поток сохранённой расстановки при текущих матрицах - верхняя оценка
+// для точного поиска
+Cost getUpperBound(const SavedSolution& solution, const Matrix& distances, const Matrix& amounts);
@@ -0,0 +1,615 @@
+#include "Qap.h"
+#include "BranchAndBound.h"
+#include "ParallelSearch.h"
+#include "SwapSearch.h"
+#include "BatchKernel.h"
+#include "TabuSearch.h"
+#include "Loader.h"
+#include "RankSearch.h"
+#include "BatchSolver.h"
+#include "Symmetry.h"
+#include "FixedSizeSearch.h"
+#include "Distributed.h"
+#include "WarmStart.h"
+#include "SparseFlows.h"
+#include "catch2/catch_all.hpp"
+#include <random>
+#include <limits>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <future>
+#include <thread>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+Matrix generateMatrix(int size, int maxValue, std::mt19937& generator)
+{
+    std::uniform_int_distribution<int> distribution(0, maxValue);
+    Matrix matrix(size);
+    for (int i = 0; i < size * size; i++) {
+        matrix.data()[i] = distribution(generator);
+    }
+    return matrix;
+}
+
+
+TEST_CASE("Branch and bound")
+{
+    SECTION("Assignment problem")
+    {
+        std::vector<Cost> costs = {
+            4, 1, 3,
+            2, 0, 5,
+            3, 2, 2
+        };
+        REQUIRE(solveAssignment(costs, 3) == 5);
+    }
+
+    SECTION("Same placement as full search")
+    {
+        std::mt19937 generator(42);
+        for (int size = 1; size <= 7; size++) {
+            auto distances = generateMatrix(size, 9, generator);
+            auto amounts = generateMatrix(size, 3, generator);
+
+            auto expected = findMinPath(distances, amounts);
+            auto actual = BranchAndBound(distances, amounts).solve();
+            REQUIRE(expected.cost == actual.cost);
+            REQUIRE(expected.factories == actual.factories);
+        }
+    }
+}
+
+TEST_CASE("Parallel search")
+{
+    SECTION("Prefixes in lexicographic order")
+    {
+        std::vector<std::vector<int>> prefixes = {
+            {0, 1}, {0, 2}, {1, 0}, {1, 2}, {2, 0}, {2, 1}
+        };
+        REQUIRE(prefixes == getPrefixes(3, 4));
+    }
+
+    SECTION("Same placement as full search with ties")
+    {
+        std::mt19937 generator(7);
+        ThreadPool pool(4);
+        for (int size = 1; size <= 7; size++) {
+            auto distances = generateMatrix(size, 2, generator);
+            auto amounts = generateMatrix(size, 1, generator);
+
+            auto expected = findMinPath(distances, amounts);
+            auto actual = findMinPathParallel(distances, amounts, pool);
+            REQUIRE(expected.cost == actual.cost);
+            REQUIRE(expected.factories == actual.factories);
+        }
+    }
+}
+
+TEST_CASE("Swap search")
+{
+    SECTION("Swap delta matches full recalculation")
+    {
+        std::mt19937 generator(3);
+        auto distances = generateMatrix(6, 20, generator);
+        auto amounts = generateMatrix(6, 20, generator);
+        std::vector<int> factories = {3, 0, 5, 1, 4, 2};
+
+        for (int r = 0; r < 6; r++) {
+            for (int s = r + 1; s < 6; s++) {
+                auto swapped = factories;
+                std::swap(swapped[r], swapped[s]);
+                Cost expected = calculatePath(distances, amounts, swapped)
+                    - calculatePath(distances, amounts, factories);
+                REQUIRE(expected == calculateSwapDelta(distances, amounts, factories, r, s));
+            }
+        }
+    }
+
+    SECTION("Swap delta update after another swap")
+    {
+        std::mt19937 generator(4);
+        auto distances = generateMatrix(7, 20, generator);
+        auto amounts = generateMatrix(7, 20, generator);
+        std::vector<int> factories = {6, 3, 0, 5, 1, 4, 2};
+
+        int r = 1;
+        int s = 4;
+        auto swapped = factories;
+        std::swap(swapped[r], swapped[s]);
+        for (int i = 0; i < 7; i++) {
+            for (int j = i + 1; j < 7; j++) {
+                if (i == r || i == s || j == r || j == s) {
+                    continue;
+                }
+                Cost delta = calculateSwapDelta(distances, amounts, factories, i, j);
+                REQUIRE(calculateSwapDelta(distances, amounts, swapped, i, j)
+                    == updateSwapDelta(distances, amounts, swapped, delta, i, j, r, s));
+            }
+        }
+    }
+
+    SECTION("Same placement as full search with ties")
+    {
+        std::mt19937 generator(11);
+        for (int size = 1; size <= 7; size++) {
+            auto distances = generateMatrix(size, 2, generator);
+            auto amounts = generateMatrix(size, 1, generator);
+
+            auto expected = findMinPath(distances, amounts);
+            auto actual = findMinPathBySwaps(distances, amounts);
+            REQUIRE(expected.cost == actual.cost);
+            REQUIRE(expected.factories == actual.factories);
+        }
+    }
+}
+
+TEST_CASE("Batch kernel")
+{
+    std::mt19937 generator(5);
+    auto distances = generateMatrix(9, 30, generator);
+    auto amounts = generateMatrix(9, 30, generator);
+
+    std::vector<std::vector<int>> permutations;
+    std::vector<int> factories = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    for (int lane = 0; lane < BATCH_SIZE; lane++) {
+        std::shuffle(factories.begin(), factories.end(), generator);
+        permutations.push_back(factories);
+    }
+    std::vector<int> batch(9 * BATCH_SIZE);
+    for (int lane = 0; lane < BATCH_SIZE; lane++) {
+        for (int i = 0; i < 9; i++) {
+            batch[lane * 9 + i] = permutations[lane][i];
+        }
+    }
+
+    // Ядра, которые процессор не поддерживает, проверить нельзя,
+    // поэтому сравниваются скалярное и выбранное во время выполнения
+    for (BatchKernel kernel : {calculatePathsScalar, selectBatchKernel(distances, amounts)}) {
+        Cost costs[BATCH_SIZE];
+        kernel(distances, amounts, batch.data(), costs);
+        for (int lane = 0; lane < BATCH_SIZE; lane++) {
+            REQUIRE(costs[lane] == calculatePath(distances, amounts, permutations[lane]));
+        }
+    }
+
+    // Каждое произведение помещается в int, а сумма девяти - нет
+    auto largeDistances = generateMatrix(9, 40000, generator);
+    auto largeAmounts = generateMatrix(9, 40000, generator);
+    REQUIRE(fitsInt32Lanes(distances, amounts));
+    REQUIRE(!fitsInt32Lanes(largeDistances, largeAmounts));
+    BatchKernel kernel = selectBatchKernel(largeDistances, largeAmounts);
+    REQUIRE(kernel == calculatePathsScalar);
+    Cost costs[BATCH_SIZE];
+    kernel(largeDistances, largeAmounts, batch.data(), costs);
+    for (int lane = 0; lane < BATCH_SIZE; lane++) {
+        REQUIRE(costs[lane] == calculatePath(largeDistances, largeAmounts, permutations[lane]));
+    }
+}
+
+TEST_CASE("Tabu search")
+{
+    std::mt19937 generator(9);
+    auto distances = generateMatrix(7, 20, generator);
+    auto amounts = generateMatrix(7, 20, generator);
+    auto expected = findMinPath(distances, amounts);
+
+    ThreadPool pool(2);
+    int improvements = 0;
+    auto actual = findMinPathHeuristic(distances, amounts, 0.2, pool, [&](const Placement&) {
+        improvements++;
+    });
+    REQUIRE(improvements > 0);
+    REQUIRE(actual.cost == expected.cost);
+    REQUIRE(actual.cost == calculatePath(distances, amounts, actual.factories));
+}
+
+TEST_CASE("Loader")
+{
+    auto directory = std::filesystem::temp_directory_path();
+    auto writeFile = [&](const std::string& name, const std::string& contents) {
+        auto path = (directory / name).string();
+        std::ofstream(path) << contents;
+        return path;
+    };
+    Matrix distances = {{0, 2, 3}, {2, 0, 1}, {3, 1, 0}};
+    Matrix amounts = {{0, 5, 0}, {1, 0, 4}, {7, 0, 0}};
+
+    SECTION("Two matrix files")
+    {
+        auto instance = loadInstance(
+            writeFile("qap_distance.txt", "0 2 3\n2 0 1\n3 1 0"),
+            writeFile("qap_amount.txt", "0 5 0\r\n1 0 4\r\n7 0 0\r\n")
+        );
+        REQUIRE(std::equal(distances.data(), distances.data() + 9, instance.distances.data()));
+        REQUIRE(std::equal(amounts.data(), amounts.data() + 9, instance.amounts.data()));
+    }
+
+    SECTION("QAPLIB file")
+    {
+        auto instance = loadInstance(writeFile(
+            "qap_instance.dat",
+            "   3\n\n 0 5 0\n 1 0 4\n 7 0 0\n\n 0 2 3\n 2 0 1\n 3 1 0\n"
+        ));
+        REQUIRE(instance.distances.size() == 3);
+        REQUIRE(std::equal(distances.data(), distances.data() + 9, instance.distances.data()));
+        REQUIRE(std::equal(amounts.data(), amounts.data() + 9, instance.amounts.data()));
+    }
+
+    SECTION("Invalid input")
+    {
+        REQUIRE_THROWS(loadInstance(writeFile("qap_short.dat", "3\n0 1 2\n")));
+        REQUIRE_THROWS(loadInstance(writeFile("qap_long.dat", "1\n1\n2\n3\n")));
+        REQUIRE_THROWS(loadInstance(
+            writeFile("qap_distance.txt", "0 2\n2 0"),
+            writeFile("qap_amount.txt", "0 5 0\n1 0 4\n7 0 0")
+        ));
+        REQUIRE_THROWS(loadInstance((directory / "qap_missing.dat").string()));
+    }
+}
+
+TEST_CASE("Permutation ranks")
+{
+    SECTION("Rank follows lexicographic order")
+    {
+        std::vector<int> factories = {0, 1, 2, 3, 4};
+        Rank rank = 0;
+        do
+        {
+            REQUIRE(rankPermutation(factories) == rank);
+            REQUIRE(unrankPermutation(rank, 5) == factories);
+            rank++;
+        } while (std::next_permutation(factories.begin(), factories.end()));
+        REQUIRE(rank == factorial(5));
+    }
+
+    SECTION("Split ranges and resume give the same placement")
+    {
+        std::mt19937 generator(21);
+        auto distances = generateMatrix(6, 2, generator);
+        auto amounts = generateMatrix(6, 1, generator);
+        auto expected = findMinPath(distances, amounts);
+
+        auto first = createCheckpoint(6, 0, 250);
+        findMinPathInRange(distances, amounts, first);
+        auto path = (std::filesystem::temp_directory_path() / "qap_checkpoint.txt").string();
+        saveCheckpoint(path, first);
+
+        auto resumed = loadCheckpoint(path);
+        REQUIRE(resumed.rank == 250);
+        REQUIRE(resumed.best.cost == first.best.cost);
+        REQUIRE(resumed.best.factories == first.best.factories);
+        resumed.end = factorial(6);
+        findMinPathInRange(distances, amounts, resumed);
+        REQUIRE(resumed.best.cost == expected.cost);
+        REQUIRE(resumed.best.factories == expected.factories);
+    }
+
+    SECTION("Resume checks the saved placement")
+    {
+        std::mt19937 generator(23);
+        auto distances = generateMatrix(5, 2, generator);
+        auto amounts = generateMatrix(5, 1, generator);
+        auto path = (std::filesystem::temp_directory_path() / "qap_checkpoint_check.txt").string();
+
+        // Поток в файле занижен, после восстановления он пересчитан
+        std::ofstream(path) << "size 5\nrank 10\nend 120\ncost 0\nfactories 4 3 2 1 0\n";
+        auto checkpoint = loadCheckpoint(path);
+        restoreCheckpoint(checkpoint, distances, amounts);
+        REQUIRE(checkpoint.best.cost == calculatePath(distances, amounts, {4, 3, 2, 1, 0}));
+        REQUIRE_THROWS(restoreCheckpoint(checkpoint, generateMatrix(6, 2, generator), generateMatrix(6, 1, generator)));
+
+        std::ofstream(path) << "size 5\nrank 0\nend 120\ncost 0\nfactories\n";
+        checkpoint = loadCheckpoint(path);
+        restoreCheckpoint(checkpoint, distances, amounts);
+        REQUIRE(checkpoint.best.cost == std::numeric_limits<Cost>::max());
+
+        for (const char* factories : {"0 1 2 3", "0 1 2 3 3", "0 1 2 3 5", "0 1 2 3 4 0"}) {
+            std::ofstream(path) << "size 5\nrank 0\nend 120\ncost 0\nfactories " << factories << "\n";
+            REQUIRE_THROWS(loadCheckpoint(path));
+        }
+    }
+}
+
+TEST_CASE("Batch solver")
+{
+    auto directory = std::filesystem::temp_directory_path() / "qap_batch";
+    std::filesystem::create_directories(directory);
+    std::ofstream(directory / "b.dat") << "2\n0 3\n1 0\n0 1\n5 0\n";
+    std::ofstream(directory / "a.dat") << "1\n2\n3\n";
+    std::ofstream(directory / "broken.dat") << "2\n0 3\n";
+    std::ofstream(directory / "notes.txt") << "skip";
+    std::ofstream(directory / "manifest") << "# comment\n\na.dat\nb.dat\n";
+
+    auto instances = getBatchInstances(directory.string());
+    REQUIRE(instances.size() == 3);
+    REQUIRE(instances[0].name == "a.dat");
+    REQUIRE(getBatchInstances((directory / "manifest").string()).size() == 2);
+
+    ThreadPool pool(2);
+    std::ostringstream output;
+    solveBatch(instances, pool, output, ResultFormat::Jsonl);
+
+    auto lines = output.str();
+    REQUIRE(std::count(lines.begin(), lines.end(), '\n') == 3);
+    REQUIRE(lines.find("{\"instance\":\"a.dat\",\"size\":1,\"cost\":6,\"factories\":[0]") != std::string::npos);
+    REQUIRE(lines.find("\"cost\":8,\"factories\":[0,1]") != std::string::npos);
+    REQUIRE(lines.find("\"instance\":\"broken.dat\",\"size\":0,\"error\":") != std::string::npos);
+
+    std::ostringstream plain;
+    solveBatch(getBatchInstances((directory / "manifest").string()), pool, plain, ResultFormat::Jsonl, false);
+    lines = plain.str();
+    REQUIRE(lines.find("\"cost\":8,\"factories\":[0,1]") != std::string::npos);
+}
+
+TEST_CASE("Symmetry reduction")
+{
+    SECTION("Automorphisms of a cycle")
+    {
+        Matrix cycle(5);
+        for (int i = 0; i < 5; i++) {
+            cycle[i][(i + 1) % 5] = 1;
+            cycle[(i + 1) % 5][i] = 1;
+        }
+        REQUIRE(isSymmetric(cycle));
+        REQUIRE(findAutomorphisms(cycle).size() == 9);
+        for (const auto& automorphism : findAutomorphisms(cycle)) {
+            for (int i = 0; i < 5; i++) {
+                for (int j = 0; j < 5; j++) {
+                    REQUIRE(cycle[automorphism[i]][automorphism[j]] == cycle[i][j]);
+                }
+            }
+        }
+    }
+
+    SECTION("Same placement as full search with symmetric flows")
+    {
+        std::mt19937 generator(17);
+        for (int size = 3; size <= 7; size++) {
+            auto distances = generateMatrix(size, 9, generator);
+            // Все фабрики, кроме последней, неразличимы
+            Matrix amounts(size, 1);
+            for (int i = 0; i < size; i++) {
+                amounts[i][i] = 0;
+                amounts[i][size - 1] = 3;
+            }
+            auto symmetry = detectSymmetry(distances, amounts);
+            REQUIRE(!symmetry.factoryAutomorphisms.empty());
+
+            auto expected = findMinPath(distances, amounts);
+            auto actual = BranchAndBound(distances, amounts, symmetry.factoryAutomorphisms).solve();
+            REQUIRE(expected.cost == actual.cost);
+            REQUIRE(expected.factories == actual.factories);
+
+            ThreadPool pool(3);
+            auto parallel = findMinPathParallel(distances, amounts, pool, symmetry.factoryAutomorphisms);
+            REQUIRE(expected.factories == parallel.factories);
+        }
+    }
+
+    SECTION("Transposed search for location symmetries")
+    {
+        std::mt19937 generator(19);
+        Matrix distances(6, 2);
+        auto amounts = generateMatrix(6, 9, generator);
+        auto solve = [](const Matrix& distances, const Matrix& amounts, const Automorphisms& automorphisms) {
+            return BranchAndBound(distances, amounts, automorphisms).solve();
+        };
+        auto expected = findMinPath(distances, amounts);
+
+        // Без явного разрешения задача не транспонируется и выбирает тот же оптимум
+        auto symmetry = detectSymmetry(distances, amounts);
+        REQUIRE(symmetry.locationAutomorphisms.empty());
+        auto actual = solveReduced(distances, amounts, symmetry, solve);
+        REQUIRE(expected.cost == actual.cost);
+        REQUIRE(expected.factories == actual.factories);
+
+        auto transposable = detectSymmetry(distances, amounts, true);
+        REQUIRE(transposable.locationAutomorphisms.size() > transposable.factoryAutomorphisms.size());
+        auto transposed = solveReduced(distances, amounts, transposable, solve);
+        REQUIRE(isPermutation(transposed.factories, 6));
+        REQUIRE(expected.cost == transposed.cost);
+        REQUIRE(expected.cost == calculatePath(distances, amounts, transposed.factories));
+    }
+}
+
+TEST_CASE("Fixed size search")
+{
+    std::mt19937 generator(23);
+    auto distances = generateMatrix(9, 50, generator);
+    auto amounts = generateMatrix(9, 50, generator);
+    auto start = unrankPermutation(123456, 9);
+
+    Placement expected;
+    expected.cost = std::numeric_limits<Cost>::max();
+    auto factories = start;
+    for (int k = 0; k < 5000; k++) {
+        Cost path = calculatePath(distances, amounts, factories);
+        if (path < expected.cost) {
+            expected = {factories, path};
+        }
+        std::next_permutation(factories.begin(), factories.end());
+    }
+
+    FixedInstance<9> instance(distances, amounts);
+    std::vector<RangeScanner> scanners = {
+        getFixedSizeScanner(distances, amounts),
+        [&](std::vector<int>& factories, unsigned long long count, Placement& best) {
+            scanFixedScalar<9>(instance, factories, count, best);
+        }
+    };
+    for (const auto& scan : scanners) {
+        Placement actual;
+        actual.cost = std::numeric_limits<Cost>::max();
+        auto current = start;
+        scan(current, 2000, actual);
+        scan(current, 3000, actual);
+        REQUIRE(current == factories);
+        REQUIRE(actual.cost == expected.cost);
+        REQUIRE(actual.factories == expected.factories);
+    }
+    REQUIRE(!getFixedSizeScanner(generateMatrix(7, 1, generator), generateMatrix(7, 1, generator)));
+    REQUIRE(!getFixedSizeScanner(generateMatrix(9, 40000, generator), generateMatrix(9, 40000, generator)));
+}
+
+TEST_CASE("Distributed search")
+{
+    std::mt19937 generator(11);
+    auto distances = generateMatrix(7, 2, generator);
+    auto amounts = generateMatrix(7, 1, generator);
+    auto expected = findMinPath(distances, amounts);
+
+    Coordinator coordinator(distances, amounts, 0);
+    int port = coordinator.getPort();
+    auto result = std::async(std::launch::async, [&] { return coordinator.run(); });
+
+    SECTION("Same placement as full search with ties")
+    {
+        std::vector<std::thread> workers;
+        for (int i = 0; i < 3; i++) {
+            workers.emplace_back([&] { runWorker(distances, amounts, "localhost", port); });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    SECTION("Subtree of lost worker is reassigned")
+    {
+        int socket = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        REQUIRE(connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+
+        std::string hello = "HELLO 7 " + std::to_string(hashInstance(distances, amounts)) + "\n";
+        send(socket, hello.data(), hello.size(), 0);
+        std::string received;
+        char data[256];
+        while (received.find('\n') == std::string::npos) {
+            ssize_t count = recv(socket, data, sizeof(data), 0);
+            REQUIRE(count > 0);
+            received.append(data, count);
+        }
+        REQUIRE(received.rfind("TASK 0 ", 0) == 0);
+        close(socket);
+
+        runWorker(distances, amounts, "localhost", port);
+    }
+
+    SECTION("Worker with other instance is rejected")
+    {
+        auto other = generateMatrix(7, 2, generator);
+        REQUIRE_THROWS(runWorker(other, amounts, "localhost", port));
+        runWorker(distances, amounts, "localhost", port);
+    }
+
+    auto actual = result.get();
+    REQUIRE(expected.cost == actual.cost);
+    REQUIRE(expected.factories == actual.factories);
+}
+
+TEST_CASE("Warm start")
+{
+    SECTION("Same placement as cold search after flow change")
+    {
+        std::mt19937 generator(21);
+        ThreadPool pool(4);
+        for (int size = 3; size <= 8; size++) {
+            auto distances = generateMatrix(size, 3, generator);
+            auto amounts = generateMatrix(size, 2, generator);
+            auto previous = BranchAndBound(distances, amounts).solve();
+
+            amounts[0][size - 1] += 1;
+            amounts[size - 1][1] = 0;
+            Cost upperBound = calculatePath(distances, amounts, previous.factories);
+
+            auto expected = findMinPath(distances, amounts);
+            auto actual = BranchAndBound(distances, amounts).solve(upperBound);
+            REQUIRE(expected.cost == actual.cost);
+            REQUIRE(expected.factories == actual.factories);
+
+            actual = findMinPathParallel(distances, amounts, pool, {}, upperBound);
+            REQUIRE(expected.cost == actual.cost);
+            REQUIRE(expected.factories == actual.factories);
+        }
+    }
+
+    SECTION("Saved solution")
+    {
+        Matrix distances = {{0, 2, 5}, {2, 0, 1}, {5, 1, 0}};
+        Matrix amounts = {{0, 3, 1}, {3, 0, 4}, {1, 4, 0}};
+        auto fileName = (std::filesystem::temp_directory_path() / "qap_warm_start_test.sol").string();
+
+        SavedSolution saved{3, hashInstance(distances, amounts), {{2, 0, 1}, 0}};
+        saved.placement.cost = calculatePath(distances, amounts, saved.placement.factories);
+        saveSolution(fileName, saved);
+        auto loaded = loadSolution(fileName);
+        REQUIRE(loaded.instanceHash == saved.instanceHash);
+        REQUIRE(loaded.placement.factories == saved.placement.factories);
+
+        amounts[0][1] = 7;
+        REQUIRE(hashInstance(distances, amounts) != loaded.instanceHash);
+        REQUIRE(getUpperBound(loaded, distances, amounts) == calculatePath(distances, amounts, {2, 0, 1}));
+        REQUIRE_THROWS(getUpperBound(loaded, Matrix(4), Matrix(4)));
+
+        std::ofstream(fileName) << "size 3\nfactories 0 0 1\n";
+        REQUIRE_THROWS(loadSolution(fileName));
+        std::filesystem::remove(fileName);
+    }
+}
+
+TEST_CASE("Sparse flows")
+{
+    std::mt19937 generator(17);
+    auto makeSparse = [&](int size) {
+        auto amounts = generateMatrix(size, 9, generator);
+        std::bernoulli_distribution isZero(0.85);
+        for (int i = 0; i < size * size; i++) {
+            if (isZero(generator)) {
+                amounts.data()[i] = 0;
+            }
+        }
+        return amounts;
+    };
+
+    REQUIRE(isSparse(makeSparse(10)));
+    REQUIRE(!isSparse(Matrix(10, 1)));
+
+    SECTION("Path and swap delta match dense calculation")
+    {
+        auto distances = generateMatrix(9, 20, generator);
+        auto amounts = makeSparse(9);
+        amounts[2][2] = 5;
+        amounts[2][6] = 3;
+        amounts[6][2] = 4;
+        SparseFlows flows(amounts);
+
+        std::vector<int> factories = {2, 7, 0, 6, 3, 8, 1, 5, 4};
+        auto locations = invertPermutation(factories);
+        REQUIRE(flows.calculatePath(distances, locations) == calculatePath(distances, amounts, factories));
+        for (int r = 0; r < 9; r++) {
+            for (int s = r + 1; s < 9; s++) {
+                REQUIRE(flows.calculateSwapDelta(distances, factories, locations, r, s)
+                    == calculateSwapDelta(distances, amounts, factories, r, s));
+            }
+        }
+    }
+
+    SECTION("Swap search with sparse flows")
+    {
+        for (int size = 2; size <= 7; size++) {
+            auto distances = generateMatrix(size, 2, generator);
+            auto amounts = makeSparse(size);
+
+            auto expected = findMinPath(distances, amounts);
+            auto actual = findMinPathBySwaps(distances, amounts);
+            REQUIRE(expected.cost == actual.cost);
+            REQUIRE(expected.factories == actual.factories);
+        }
+    }
+}
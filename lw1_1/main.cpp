@@ -1,44 +1,188 @@
+#include "Qap/Qap.h"
+#include "Qap/BranchAndBound.h"
+#include "Qap/ParallelSearch.h"
+#include "Qap/SwapSearch.h"
+#include "Qap/TabuSearch.h"
+#include "Qap/Loader.h"
+#include "Qap/RankSearch.h"
+#include "Qap/BatchSolver.h"
+#include "Qap/Symmetry.h"
+#include "Qap/Distributed.h"
+#include "Qap/WarmStart.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
-#include <numeric>
 #include <algorithm>
 #include <vector>
 #include <iterator>
-#include <limits>
 #include <chrono>
+#include <filesystem>
+#include <limits>
+#include <optional>
 
 
 const double NANO_IN_SECOND = 1000000000;
 const long YEARS = NANO_IN_SECOND * 3600 * 24 * 365;
 
+const double DEFAULT_TIME_LIMIT = 10;
+const double DEFAULT_CHECKPOINT_INTERVAL = 60;
+
+const char* const USAGE =
+    "qap [режим] [параметры] <файл QAPLIB> | <файл расстояний> <файл потоков>\n"
+    "Режимы:\n"
+    "  (без режима)          полный перебор, --range=ПЕРВЫЙ:ПОСЛЕДНИЙ, --checkpoint=ФАЙЛ,\n"
+    "                        --checkpoint-interval=СЕКУНДЫ, --resume\n"
+    "  --swaps               перебор обменами\n"
+    "  --heuristic           поиск с запретами, --time-limit=СЕКУНДЫ, --threads=N\n"
+    "  --branch-and-bound    метод ветвей и границ\n"
+    "  --parallel            параллельный метод ветвей и границ, --threads=N\n"
+    "  --coordinate=ПОРТ     координатор распределённого перебора\n"
+    "  --worker=АДРЕС:ПОРТ   рабочий распределённого перебора\n"
+    "  --batch=ПУТЬ          пакет задач, --output=ФАЙЛ.csv|.jsonl, --threads=N\n"
+    "Для методов ветвей и границ и пакета: --no-symmetry, --transpose-symmetry,\n"
+    "--warm-start=ФАЙЛ (кроме пакета).\n"
+    "Разреженная матрица потоков (ненулевых не больше четверти) ускоряет только\n"
+    "--swaps и --heuristic: полный перебор упирается в обход перестановок, и\n"
+    "разреженный подсчёт потока его не ускоряет.\n";
 
+enum class Mode
+{
+    FullSearch,
+    Swaps,
+    BranchAndBound,
+    Parallel,
+    Heuristic,
+    Coordinator,
+    Worker,
+};
+
+struct Options
+{
+    Mode mode = Mode::FullSearch;
+    int threadCount = getDefaultThreadCount();
+    double timeLimit = DEFAULT_TIME_LIMIT;
+    std::string checkpointFileName;
+    double checkpointInterval = DEFAULT_CHECKPOINT_INTERVAL;
+    bool resume = false;
+    bool hasRange = false;
+    Rank rangeFirst = 0;
+    Rank rangeLast = 0;
+    bool useSymmetry = true;
+    // Транспонирование может сменить выбор среди равных оптимумов, поэтому
+    // включается только явно
+    bool transposeSymmetry = false;
+    std::string batchPath;
+    std::string outputFileName;
+    int port = 0;
+    std::string coordinatorHost;
+    std::string warmStartFileName;
+    std::vector<std::string> fileNames;
+};
+
+
+Options parseArguments(int argc, char* args[]);
 void assertInputValid(int fileCount);
-std::ifstream openFile(const std::string& fileName);
-std::vector<std::vector<int>> getMatrix(std::ifstream& inputFile);
-void assertMatrixSizesAreEqual(std::vector<std::vector<int>> matrix1, std::vector<std::vector<int>> matrix2);
-void printMinPath( std::vector<std::vector<int>> distances, std::vector<std::vector<int>> amounts);
+Instance getInstance(const std::vector<std::string>& fileNames);
+void printMinPath(const Placement& placement);
 void exitWithMessage(const std::string& message);
+int parseNumber(const std::string& argument, const std::string& prefix);
+double parseSeconds(const std::string& argument, const std::string& prefix);
+void parseRange(const std::string& argument, const std::string& prefix, Options& options);
+void parseAddress(const std::string& argument, const std::string& prefix, Options& options);
+void printImprovement(const Placement& placement, Clock::time_point startTime);
+bool isRangeSearch(const Options& options);
+Placement findMinPathInRange(const Options& options, const Matrix& distances, const Matrix& amounts);
+void solveBatch(const Options& options);
+SymmetryInfo getSymmetry(const Options& options, const Matrix& distances, const Matrix& amounts);
+Placement coordinateSearch(const Options& options, const Matrix& distances, const Matrix& amounts);
+void runWorker(const Options& options, const Matrix& distances, const Matrix& amounts);
+std::optional<Placement> loadWarmStart(const Options& options, const Matrix& distances, const Matrix& amounts,
+                                       Cost& upperBound);
+void saveWarmStart(const Options& options, const Matrix& distances, const Matrix& amounts,
+                   const Placement& placement);
 double calculateTime(double currentTime, int iterations, int currentSize);
 
 
 int main(int argc, char* args[])
 {
-    assertInputValid(argc);
-
-    auto distanceFile = openFile(args[1]);
-    auto amountFile = openFile(args[2]);
+    auto options = parseArguments(argc, args);
+    if (!options.batchPath.empty()) {
+        solveBatch(options);
+        return 0;
+    }
 
-    auto distances = getMatrix(distanceFile);
-    auto amounts = getMatrix(amountFile);
-    assertMatrixSizesAreEqual(distances, amounts);
+    auto instance = getInstance(options.fileNames);
+    const auto& distances = instance.distances;
+    const auto& amounts = instance.amounts;
 
     auto startTime = std::chrono::high_resolution_clock::now();
-    printMinPath(distances, amounts);
+    Cost upperBound = std::numeric_limits<Cost>::max();
+    if (auto cached = loadWarmStart(options, distances, amounts, upperBound)) {
+        printMinPath(*cached);
+        return 0;
+    }
+
+    Placement placement;
+    switch (options.mode) {
+        case Mode::FullSearch:
+            if (isRangeSearch(options)) {
+                placement = findMinPathInRange(options, distances, amounts);
+            } else {
+                placement = findMinPath(distances, amounts);
+            }
+            break;
+        case Mode::Swaps:
+            placement = findMinPathBySwaps(distances, amounts);
+            break;
+        case Mode::BranchAndBound:
+            placement = solveReduced(
+                distances,
+                amounts,
+                getSymmetry(options, distances, amounts),
+                [&](const Matrix& distances, const Matrix& amounts, const Automorphisms& automorphisms) {
+                    return BranchAndBound(distances, amounts, automorphisms).solve(upperBound);
+                }
+            );
+            break;
+        case Mode::Parallel: {
+            ThreadPool pool(options.threadCount);
+            placement = solveReduced(
+                distances,
+                amounts,
+                getSymmetry(options, distances, amounts),
+                [&](const Matrix& distances, const Matrix& amounts, const Automorphisms& automorphisms) {
+                    return findMinPathParallel(distances, amounts, pool, automorphisms, upperBound);
+                }
+            );
+            break;
+        }
+        case Mode::Heuristic: {
+            ThreadPool pool(options.threadCount);
+            auto searchStart = Clock::now();
+            placement = findMinPathHeuristic(
+                distances,
+                amounts,
+                options.timeLimit,
+                pool,
+                [&](const Placement& improved) { printImprovement(improved, searchStart); }
+            );
+            break;
+        }
+        case Mode::Coordinator:
+            placement = coordinateSearch(options, distances, amounts);
+            break;
+        case Mode::Worker:
+            runWorker(options, distances, amounts);
+            return 0;
+    }
+    printMinPath(placement);
+    saveWarmStart(options, distances, amounts, placement);
     auto endTime = std::chrono::high_resolution_clock::now();
     auto time = (endTime - startTime).count();
 
     std::cout << "Время выполнения: " << time / NANO_IN_SECOND << " секунд" << std::endl << std::endl;
+    if ((options.mode != Mode::FullSearch && options.mode != Mode::Swaps) || isRangeSearch(options)) {
+        return 0;
+    }
     std::cout << "Время выполнения для 20 элементов: "
               << calculateTime(time, 20, distances.size())<< " лет"<< std::endl;
     std::cout << "Время выполнения для 50 элементов: "
@@ -52,108 +196,324 @@ void exitWithMessage(const std::string& message)
     exit(1);
 }
 
-void assertInputValid(int fileCount)
+Options parseArguments(int argc, char* args[])
 {
-    const int VALID_FILE_COUNT = 3;
+    Options options;
 
-    if (fileCount != VALID_FILE_COUNT) {
-        exitWithMessage("Передано неверное количество файлов");
+    for (int i = 1; i < argc; i++) {
+        std::string argument = args[i];
+        if (argument == "--branch-and-bound") {
+            options.mode = Mode::BranchAndBound;
+        } else if (argument == "--parallel") {
+            options.mode = Mode::Parallel;
+        } else if (argument == "--swaps") {
+            options.mode = Mode::Swaps;
+        } else if (argument == "--heuristic") {
+            options.mode = Mode::Heuristic;
+        } else if (argument.rfind("--threads=", 0) == 0) {
+            options.threadCount = parseNumber(argument, "--threads=");
+        } else if (argument.rfind("--time-limit=", 0) == 0) {
+            options.timeLimit = parseSeconds(argument, "--time-limit=");
+        } else if (argument.rfind("--checkpoint=", 0) == 0) {
+            options.checkpointFileName = argument.substr(std::string("--checkpoint=").size());
+        } else if (argument.rfind("--checkpoint-interval=", 0) == 0) {
+            options.checkpointInterval = parseSeconds(argument, "--checkpoint-interval=");
+        } else if (argument == "--resume") {
+            options.resume = true;
+        } else if (argument.rfind("--range=", 0) == 0) {
+            parseRange(argument, "--range=", options);
+        } else if (argument == "--no-symmetry") {
+            options.useSymmetry = false;
+        } else if (argument == "--transpose-symmetry") {
+            options.transposeSymmetry = true;
+        } else if (argument.rfind("--batch=", 0) == 0) {
+            options.batchPath = argument.substr(std::string("--batch=").size());
+        } else if (argument.rfind("--output=", 0) == 0) {
+            options.outputFileName = argument.substr(std::string("--output=").size());
+        } else if (argument.rfind("--coordinate=", 0) == 0) {
+            options.mode = Mode::Coordinator;
+            options.port = parseNumber(argument, "--coordinate=");
+        } else if (argument.rfind("--worker=", 0) == 0) {
+            options.mode = Mode::Worker;
+            parseAddress(argument, "--worker=", options);
+        } else if (argument.rfind("--warm-start=", 0) == 0) {
+            options.warmStartFileName = argument.substr(std::string("--warm-start=").size());
+        } else if (argument.rfind("--", 0) == 0) {
+            exitWithMessage("Неизвестный параметр: " + argument + "\n\n" + USAGE);
+        } else {
+            options.fileNames.push_back(argument);
+        }
+    }
+    if (!options.batchPath.empty()) {
+        if (!options.fileNames.empty() || isRangeSearch(options)) {
+            exitWithMessage("В пакетном режиме задачи берутся только из --batch");
+        }
+        return options;
     }
+    assertInputValid(options.fileNames.size() + 1);
+
+    if (isRangeSearch(options) && options.mode != Mode::FullSearch) {
+        exitWithMessage("Контрольные точки и диапазоны доступны только для полного перебора");
+    }
+    if (!options.warmStartFileName.empty()
+        && options.mode != Mode::BranchAndBound && options.mode != Mode::Parallel) {
+        exitWithMessage("Тёплый старт доступен только для метода ветвей и границ");
+    }
+    if (options.resume && options.checkpointFileName.empty()) {
+        exitWithMessage("Для продолжения перебора нужен параметр --checkpoint=ФАЙЛ");
+    }
+    if (options.resume && options.hasRange) {
+        exitWithMessage("Диапазон продолжаемого перебора берётся из контрольной точки");
+    }
+    return options;
 }
 
-void assertFileValid(std::ifstream& file)
+int parseNumber(const std::string& argument, const std::string& prefix)
 {
-    if (!file.is_open()) {
-        exitWithMessage("Ошибка открытия файла");
+    try {
+        size_t length;
+        std::string value = argument.substr(prefix.size());
+        int number = std::stoi(value, &length);
+        if (length == value.size() && number > 0) {
+            return number;
+        }
+    } catch (const std::exception&) {
     }
+    exitWithMessage("Неверное значение параметра: " + argument);
+    return 0;
 }
 
-void assertMatrixSizesAreEqual(
-    std::vector<std::vector<int>> matrix1,
-    std::vector<std::vector<int>> matrix2
-)
+double parseSeconds(const std::string& argument, const std::string& prefix)
 {
-    bool rowsCountIsEqual = matrix1.size() == matrix2.size();
-    bool columnsCountIsEqual = matrix1[0].size() == matrix2[0].size();
+    try {
+        size_t length;
+        std::string value = argument.substr(prefix.size());
+        double seconds = std::stod(value, &length);
+        if (length == value.size() && seconds > 0) {
+            return seconds;
+        }
+    } catch (const std::exception&) {
+    }
+    exitWithMessage("Неверное значение параметра: " + argument);
+    return 0;
+}
 
-    if (!rowsCountIsEqual || !columnsCountIsEqual) {
-        exitWithMessage("Количество элементов в матрицах различно");
+void parseRange(const std::string& argument, const std::string& prefix, Options& options)
+{
+    std::string value = argument.substr(prefix.size());
+    auto separator = value.find(':');
+    try {
+        size_t firstLength;
+        size_t lastLength;
+        std::string first = value.substr(0, separator);
+        std::string last = separator == std::string::npos ? "" : value.substr(separator + 1);
+        options.rangeFirst = std::stoull(first, &firstLength);
+        options.rangeLast = std::stoull(last, &lastLength);
+        if (firstLength == first.size() && lastLength == last.size()) {
+            options.hasRange = true;
+            return;
+        }
+    } catch (const std::exception&) {
     }
+    exitWithMessage("Неверное значение параметра: " + argument);
 }
 
-std::ifstream openFile(const std::string& fileName)
+void parseAddress(const std::string& argument, const std::string& prefix, Options& options)
 {
-    std::ifstream file(fileName);
-    assertFileValid(file);
-    return file;
+    std::string value = argument.substr(prefix.size());
+    auto separator = value.rfind(':');
+    if (separator == 0 || separator == std::string::npos) {
+        exitWithMessage("Неверное значение параметра: " + argument);
+    }
+    options.coordinatorHost = value.substr(0, separator);
+    options.port = parseNumber(argument, prefix + options.coordinatorHost + ":");
 }
 
-std::vector<std::vector<int>> getMatrix(std::ifstream& inputFile)
+void assertInputValid(int fileCount)
 {
-    std::vector<std::vector<int>> matrix;
-    std::string line;
+    const int QAPLIB_FILE_COUNT = 2;
+    const int MATRIX_FILE_COUNT = 3;
 
-    std::getline(inputFile, line);
-    std::istringstream iss(line);
-    int num;
+    if (fileCount != QAPLIB_FILE_COUNT && fileCount != MATRIX_FILE_COUNT) {
+        exitWithMessage("Передано неверное количество файлов\n\n" + std::string(USAGE));
+    }
+}
 
-    std::vector<int> firstRow;
-    while (iss >> num) {
-        firstRow.push_back(num);
+Instance getInstance(const std::vector<std::string>& fileNames)
+{
+    try {
+        return loadInstance(fileNames);
+    } catch (const std::exception& exception) {
+        exitWithMessage(exception.what());
     }
-    matrix.push_back(firstRow);
+    return {};
+}
 
-    int matrixSize = firstRow.size();
+bool isRangeSearch(const Options& options)
+{
+    return options.hasRange || options.resume || !options.checkpointFileName.empty();
+}
 
-    for (int i = 1; i < matrixSize; i++) {
-        std::getline(inputFile, line);
-        std::istringstream iss(line);
+Placement findMinPathInRange(
+    const Options& options,
+    const Matrix& distances,
+    const Matrix& amounts
+)
+{
+    int size = static_cast<int>(distances.size());
+    try {
+        Checkpoint progress;
+        if (options.resume) {
+            progress = loadCheckpoint(options.checkpointFileName);
+            restoreCheckpoint(progress, distances, amounts);
+            std::cout << "Продолжение с перестановки " << progress.rank
+                      << " из " << progress.end << std::endl << std::endl;
+        } else if (options.hasRange) {
+            progress = createCheckpoint(size, options.rangeFirst, options.rangeLast);
+        } else {
+            progress = createCheckpoint(size, 0, factorial(size));
+        }
+
+        findMinPathInRange(distances, amounts, progress, options.checkpointInterval, [&](const Checkpoint& checkpoint) {
+            if (!options.checkpointFileName.empty()) {
+                saveCheckpoint(options.checkpointFileName, checkpoint);
+            }
+        });
+        std::cout << "Перебрано перестановок до номера " << progress.end
+                  << " за " << progress.elapsed << " секунд" << std::endl << std::endl;
+        return progress.best;
+    } catch (const std::exception& exception) {
+        exitWithMessage(exception.what());
+    }
+    return {};
+}
 
-        std::vector<int> row;
-        for (int j = 0; j < matrixSize; j++) {
-            iss >> num;
-            row.push_back(num);
+void solveBatch(const Options& options)
+{
+    try {
+        auto instances = getBatchInstances(options.batchPath);
+        ThreadPool pool(options.threadCount);
+
+        if (options.outputFileName.empty()) {
+            solveBatch(instances, pool, std::cout, ResultFormat::Csv, options.useSymmetry, options.transposeSymmetry);
+            return;
+        }
+        std::ofstream output(options.outputFileName);
+        if (!output.is_open()) {
+            exitWithMessage("Ошибка открытия файла " + options.outputFileName);
         }
-        matrix.push_back(row);
+        solveBatch(instances, pool, output, getResultFormat(options.outputFileName),
+                   options.useSymmetry, options.transposeSymmetry);
+    } catch (const std::exception& exception) {
+        exitWithMessage(exception.what());
     }
-    return matrix;
 }
 
-void printMinPath(
-    std::vector<std::vector<int>> distances,
-    std::vector<std::vector<int>> amounts
-)
+SymmetryInfo getSymmetry(const Options& options, const Matrix& distances, const Matrix& amounts)
 {
-    int minPath = std::numeric_limits<int>::max();
-    std::vector<int> path;
+    if (!options.useSymmetry) {
+        return {};
+    }
+    auto symmetry = detectSymmetry(distances, amounts, options.transposeSymmetry);
+    std::cout << "Симметрий позиций: " << symmetry.locationAutomorphisms.size()
+              << ", симметрий фабрик: " << symmetry.factoryAutomorphisms.size() << std::endl << std::endl;
+    return symmetry;
+}
 
-    std::vector<int> factories(distances.size());
-    std::iota(factories.begin(), factories.end(), 0);
-    std::sort(factories.begin(), factories.end());
+Placement coordinateSearch(const Options& options, const Matrix& distances, const Matrix& amounts)
+{
+    try {
+        Coordinator coordinator(distances, amounts, options.port);
+        std::cout << "Ожидание рабочих на порту " << coordinator.getPort() << std::endl << std::endl;
+        auto searchStart = Clock::now();
+        return coordinator.run([&](const Placement& improved) { printImprovement(improved, searchStart); });
+    } catch (const std::exception& exception) {
+        exitWithMessage(exception.what());
+    }
+    return {};
+}
 
-    do
-    {
-        int currentPath = 0;
+// Рабочий учитывает только симметрии фабрик: транспонирование задачи
+// поменяло бы поддеревья, которые раздаёт координатор
+void runWorker(const Options& options, const Matrix& distances, const Matrix& amounts)
+{
+    try {
+        auto symmetry = getSymmetry(options, distances, amounts);
+        runWorker(distances, amounts, options.coordinatorHost, options.port, symmetry.factoryAutomorphisms);
+        std::cout << "Все поддеревья обойдены" << std::endl;
+    } catch (const std::exception& exception) {
+        exitWithMessage(exception.what());
+    }
+}
 
-        for (int i = 0; i < distances.size(); i++) {
-            for (int j = 0; j < distances[i].size(); j++) {
-                currentPath += distances[i][j] * amounts[factories[i]][factories[j]];
-            }
-        }
-        if (currentPath < minPath) {
-            minPath = currentPath;
-            path = factories;
+// Решение той же задачи возвращается сразу, решение с другими потоками даёт
+// верхнюю оценку. Файла при первом запуске ещё нет.
+std::optional<Placement> loadWarmStart(
+    const Options& options,
+    const Matrix& distances,
+    const Matrix& amounts,
+    Cost& upperBound
+)
+{
+    if (options.warmStartFileName.empty() || !std::filesystem::exists(options.warmStartFileName)) {
+        return std::nullopt;
+    }
+    try {
+        auto solution = loadSolution(options.warmStartFileName);
+        upperBound = getUpperBound(solution, distances, amounts);
+        if (solution.instanceHash == hashInstance(distances, amounts) && upperBound == solution.placement.cost) {
+            std::cout << "Задача не изменилась, решение взято из " << options.warmStartFileName
+                      << std::endl << std::endl;
+            return solution.placement;
         }
-    } while (std::next_permutation(factories.begin(), factories.end()));
+        std::cout << "Начальная оценка из " << options.warmStartFileName << ": " << upperBound
+                  << std::endl << std::endl;
+    } catch (const std::exception& exception) {
+        exitWithMessage(exception.what());
+    }
+    return std::nullopt;
+}
+
+void saveWarmStart(
+    const Options& options,
+    const Matrix& distances,
+    const Matrix& amounts,
+    const Placement& placement
+)
+{
+    if (options.warmStartFileName.empty()) {
+        return;
+    }
+    try {
+        int size = static_cast<int>(distances.size());
+        saveSolution(options.warmStartFileName, {size, hashInstance(distances, amounts), placement});
+    } catch (const std::exception& exception) {
+        exitWithMessage(exception.what());
+    }
+}
 
+void printMinPath(const Placement& placement)
+{
     std::cout << "Способ расстановки: ";
     copy(
-        path.begin(),
-        path.end(),
+        placement.factories.begin(),
+        placement.factories.end(),
         std::ostream_iterator<int>(std::cout, " ")
     );
     std::cout << std::endl << std::endl;
-    std::cout << "Минимальный поток: " << minPath << std::endl << std::endl;
+    std::cout << "Минимальный поток: " << placement.cost << std::endl << std::endl;
+}
+
+void printImprovement(const Placement& placement, Clock::time_point startTime)
+{
+    std::chrono::duration<double> elapsed = Clock::now() - startTime;
+    std::cout << "[" << elapsed.count() << " с] Поток: " << placement.cost << ", расстановка: ";
+    copy(
+        placement.factories.begin(),
+        placement.factories.end(),
+        std::ostream_iterator<int>(std::cout, " ")
+    );
+    std::cout << std::endl;
 }
 
 double calculateTime(
@@ -167,4 +527,4 @@ double calculateTime(
         currentTime *= i;
     }
     return currentTime;
-}
\ No newline at end of file
+}
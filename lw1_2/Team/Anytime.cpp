@@ -0,0 +1,429 @@
+#include "Anytime.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+
+namespace
+{
+// Команда с числом владельцев каждой работы. Пока работой владеет один
+// работник команды, m_ownerSums хранит его номер.
+class LocalSearch
+{
+public:
+    LocalSearch(const CoverageIndex& index, const std::vector<size_t>& team)
+        : m_index(index),
+          m_inTeam(index.GetWorkerCount(), false),
+          m_counts(index.GetWorkCount(), 0),
+          m_ownerSums(index.GetWorkCount(), 0),
+          m_uncoveredCount(index.GetWorkCount()),
+          m_uniqueCounts(index.GetWorkerCount(), 0),
+          m_tallies(index.GetWorkerCount(), 0),
+          m_isTabu(index.GetWorkerCount(), false)
+    {
+        for (size_t worker : team)
+        {
+            Add(worker);
+        }
+    }
+
+    const std::vector<size_t>& GetTeam() const
+    {
+        return m_team;
+    }
+
+    // Убирает работников, все работы которых покрыты кем-то ещё
+    void RemoveRedundant(std::mt19937& generator)
+    {
+        auto members = m_team;
+        std::shuffle(members.begin(), members.end(), generator);
+        for (size_t worker : members)
+        {
+            if (IsRedundant(worker))
+            {
+                Remove(worker);
+            }
+        }
+    }
+
+    // Ищет работника вне команды, который один заменяет хотя бы двоих из неё
+    bool ReplaceByOne()
+    {
+        std::fill(m_uniqueCounts.begin(), m_uniqueCounts.end(), 0);
+        // Сумма владельцев - номер работника, только если владелец один
+        for (size_t work = 0; work < m_counts.size(); work++)
+        {
+            if (m_counts[work] == 1)
+            {
+                m_uniqueCounts[m_ownerSums[work]]++;
+            }
+        }
+
+        std::vector<size_t> touched;
+        std::vector<size_t> removed;
+        for (size_t candidate = 0; candidate < m_inTeam.size(); candidate++)
+        {
+            if (m_inTeam[candidate])
+            {
+                continue;
+            }
+            touched.clear();
+            for (size_t work : m_index.GetSkills(candidate))
+            {
+                if (m_counts[work] == 1)
+                {
+                    size_t owner = m_ownerSums[work];
+                    touched.push_back(owner);
+                    m_tallies[owner]++;
+                }
+            }
+            size_t replaceableCount = 0;
+            for (size_t owner : touched)
+            {
+                replaceableCount += m_tallies[owner] == m_uniqueCounts[owner];
+            }
+            for (size_t owner : touched)
+            {
+                m_tallies[owner] = 0;
+            }
+            if (replaceableCount < 2)
+            {
+                continue;
+            }
+
+            // Работу, которой владели только двое заменяемых, кандидат может
+            // не покрывать, поэтому удаление проверяется по одному
+            Add(candidate);
+            removed.clear();
+            std::sort(touched.begin(), touched.end());
+            touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+            for (size_t owner : touched)
+            {
+                if (IsRedundant(owner))
+                {
+                    Remove(owner);
+                    removed.push_back(owner);
+                }
+            }
+            if (removed.size() >= 2)
+            {
+                return true;
+            }
+            for (size_t owner : removed)
+            {
+                Add(owner);
+            }
+            Remove(candidate);
+        }
+        return false;
+    }
+
+    // Убирает одного-двух случайных работников и жадно восстанавливает
+    // покрытие без них. Результат не хуже прежнего принимается.
+    void Perturb(std::mt19937& generator)
+    {
+        if (m_team.empty())
+        {
+            return;
+        }
+        auto previous = m_team;
+        size_t removedCount = std::min<size_t>(m_team.size(), 1 + generator() % 2);
+        for (size_t i = 0; i < removedCount; i++)
+        {
+            size_t worker = m_team[generator() % m_team.size()];
+            Remove(worker);
+            m_isTabu[worker] = true;
+        }
+        Repair(generator);
+        std::fill(m_isTabu.begin(), m_isTabu.end(), false);
+        RemoveRedundant(generator);
+
+        if (m_team.size() > previous.size())
+        {
+            for (size_t worker : std::vector<size_t>(m_team))
+            {
+                Remove(worker);
+            }
+            for (size_t worker : previous)
+            {
+                Add(worker);
+            }
+        }
+    }
+
+private:
+    void Add(size_t worker)
+    {
+        m_inTeam[worker] = true;
+        m_team.push_back(worker);
+        for (size_t work : m_index.GetSkills(worker))
+        {
+            m_uncoveredCount -= m_counts[work]++ == 0;
+            m_ownerSums[work] += worker;
+        }
+    }
+
+    void Remove(size_t worker)
+    {
+        m_inTeam[worker] = false;
+        m_team.erase(std::find(m_team.begin(), m_team.end(), worker));
+        for (size_t work : m_index.GetSkills(worker))
+        {
+            m_uncoveredCount += --m_counts[work] == 0;
+            m_ownerSums[work] -= worker;
+        }
+    }
+
+    bool IsRedundant(size_t worker) const
+    {
+        auto skills = m_index.GetSkills(worker);
+        return std::all_of(skills.begin(), skills.end(), [&](size_t work) { return m_counts[work] >= 2; });
+    }
+
+    // Жадное покрытие с равновероятным выбором среди равных. Запрещённые
+    // работники берутся, только если без них покрыть нельзя.
+    void Repair(std::mt19937& generator)
+    {
+        while (m_uncoveredCount > 0)
+        {
+            size_t bestWorker = 0;
+            size_t bestGain = 0;
+            size_t tieCount = 0;
+            for (size_t worker = 0; worker < m_inTeam.size(); worker++)
+            {
+                if (m_inTeam[worker] || m_isTabu[worker])
+                {
+                    continue;
+                }
+                auto skills = m_index.GetSkills(worker);
+                size_t gain = std::count_if(skills.begin(), skills.end(),
+                                            [&](size_t work) { return m_counts[work] == 0; });
+                if (gain > bestGain)
+                {
+                    bestWorker = worker;
+                    bestGain = gain;
+                    tieCount = 1;
+                }
+                else if (gain == bestGain && gain > 0 && generator() % ++tieCount == 0)
+                {
+                    bestWorker = worker;
+                }
+            }
+            if (bestGain == 0)
+            {
+                std::fill(m_isTabu.begin(), m_isTabu.end(), false);
+                continue;
+            }
+            Add(bestWorker);
+        }
+    }
+
+    const CoverageIndex& m_index;
+    std::vector<bool> m_inTeam;
+    std::vector<size_t> m_team;
+    std::vector<unsigned> m_counts;
+    std::vector<size_t> m_ownerSums;
+    size_t m_uncoveredCount;
+    std::vector<size_t> m_uniqueCounts;
+    std::vector<size_t> m_tallies;
+    std::vector<bool> m_isTabu;
+};
+}
+
+std::vector<size_t> FindGreedyTeam(const CoverageIndex& index)
+{
+    std::vector<bool> covered(index.GetWorkCount(), false);
+    size_t uncoveredCount = covered.size();
+    std::vector<size_t> team;
+    while (uncoveredCount > 0)
+    {
+        size_t bestWorker = 0;
+        size_t bestGain = 0;
+        for (size_t worker = 0; worker < index.GetWorkerCount(); worker++)
+        {
+            auto skills = index.GetSkills(worker);
+            size_t gain = std::count_if(skills.begin(), skills.end(), [&](size_t work) { return !covered[work]; });
+            if (gain > bestGain)
+            {
+                bestWorker = worker;
+                bestGain = gain;
+            }
+        }
+        if (bestGain == 0)
+        {
+            return {};
+        }
+        for (size_t work : index.GetSkills(bestWorker))
+        {
+            uncoveredCount -= !covered[work];
+            covered[work] = true;
+        }
+        team.push_back(bestWorker);
+    }
+    return team;
+}
+
+size_t GetLowerBound(const CoverageIndex& index, size_t upperBound)
+{
+    size_t workCount = index.GetWorkCount();
+    size_t workersNumber = index.GetWorkerCount();
+    std::vector<std::vector<size_t>> owners(workCount);
+    for (size_t worker = 0; worker < workersNumber; worker++)
+    {
+        for (size_t work : index.GetSkills(worker))
+        {
+            owners[work].push_back(worker);
+        }
+    }
+    std::vector<size_t> works(workCount);
+    for (size_t work = 0; work < workCount; work++)
+    {
+        works[work] = work;
+    }
+    std::stable_sort(works.begin(), works.end(),
+                     [&](size_t left, size_t right) { return owners[left].size() < owners[right].size(); });
+
+    // Подъём двойственных весов: slacks[w] - насколько ещё можно поднять
+    // сумму весов навыков работника w
+    std::vector<double> weights(workCount, 0);
+    std::vector<double> slacks(workersNumber, 1);
+    double best = 0;
+    for (size_t work : works)
+    {
+        if (owners[work].empty())
+        {
+            continue;
+        }
+        double weight = 1;
+        for (size_t worker : owners[work])
+        {
+            weight = std::min(weight, slacks[worker]);
+        }
+        for (size_t worker : owners[work])
+        {
+            slacks[worker] -= weight;
+        }
+        weights[work] = weight;
+        best += weight;
+    }
+
+    // Субградиентная оптимизация лагранжиана
+    // L(u) = sum u + sum_w min(0, 1 - sum_{навыки w} u)
+    std::vector<int> subgradient(workCount);
+    double step = 2;
+    int stallCount = 0;
+    for (int iteration = 0; iteration < LAGRANGIAN_ITERATIONS && step > 1e-4; iteration++)
+    {
+        if (std::ceil(best - 1e-6) >= static_cast<double>(upperBound))
+        {
+            break;
+        }
+        double value = 0;
+        for (size_t work = 0; work < workCount; work++)
+        {
+            value += weights[work];
+            subgradient[work] = owners[work].empty() ? 0 : 1;
+        }
+        for (size_t worker = 0; worker < workersNumber; worker++)
+        {
+            auto skills = index.GetSkills(worker);
+            double reducedCost = 1;
+            for (size_t work : skills)
+            {
+                reducedCost -= weights[work];
+            }
+            if (reducedCost < 0)
+            {
+                value += reducedCost;
+                for (size_t work : skills)
+                {
+                    subgradient[work]--;
+                }
+            }
+        }
+
+        if (value > best + 1e-9)
+        {
+            best = value;
+            stallCount = 0;
+        }
+        else if (++stallCount == LAGRANGIAN_STALL)
+        {
+            step /= 2;
+            stallCount = 0;
+        }
+        double norm = 0;
+        for (int component : subgradient)
+        {
+            norm += component * component;
+        }
+        if (norm == 0)
+        {
+            break;
+        }
+        double length = step * (static_cast<double>(upperBound) - value) / norm;
+        for (size_t work = 0; work < workCount; work++)
+        {
+            weights[work] = std::max(0.0, weights[work] + length * subgradient[work]);
+        }
+    }
+    return static_cast<size_t>(std::ceil(best - 1e-6));
+}
+
+AnytimeTeam FindTeamAnytime(const CoverageIndex& index, std::chrono::milliseconds timeLimit,
+                            SharedBound* bound)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeLimit;
+    if (!index.IsCoverable())
+    {
+        return {};
+    }
+
+    std::mt19937 generator(1);
+    LocalSearch search(index, FindGreedyTeam(index));
+    search.RemoveRedundant(generator);
+    auto best = search.GetTeam();
+    size_t lowerBound = GetLowerBound(index, best.size());
+    auto offer = [&] {
+        if (bound != nullptr)
+        {
+            auto team = best;
+            std::sort(team.begin(), team.end());
+            bound->Offer(team);
+        }
+    };
+    auto isBoundDone = [&] {
+        return bound != nullptr && (bound->IsStopped() || bound->GetSize() <= lowerBound);
+    };
+    offer();
+    while (best.size() > lowerBound && std::chrono::steady_clock::now() < deadline && !isBoundDone())
+    {
+        if (search.ReplaceByOne())
+        {
+            search.RemoveRedundant(generator);
+        }
+        else
+        {
+            search.Perturb(generator);
+        }
+        if (search.GetTeam().size() < best.size())
+        {
+            best = search.GetTeam();
+            offer();
+        }
+    }
+    std::sort(best.begin(), best.end());
+    return {best, lowerBound};
+}
+
+AnytimeWorkers GetMinWorkersAnytime(const std::vector<int>& works, const Workers& workers,
+                                    std::chrono::milliseconds timeLimit)
+{
+    CoverageIndex index(works, workers);
+    auto result = FindTeamAnytime(index, timeLimit);
+    if (!result.team)
+    {
+        return {.workers = GetWorkerIds(index, result.team), .lowerBound = std::nullopt};
+    }
+    return {.workers = GetWorkerIds(index, result.team), .lowerBound = result.lowerBound};
+}
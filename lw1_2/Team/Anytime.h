@@ -0,0 +1,44 @@
+#pragma once
+#include "Coverage.h"
+#include "SharedBound.h"
+#include <chrono>
+
+
+const int LAGRANGIAN_ITERATIONS = 2000;
+// Итераций без улучшения оценки до уменьшения шага вдвое
+const int LAGRANGIAN_STALL = 20;
+
+struct AnytimeTeam
+{
+    MinTeam team;
+    // Оптимум не меньше lowerBound. Команда оптимальна, если размеры совпали.
+    size_t lowerBound = 0;
+};
+
+// Жадная команда: каждый раз берётся работник, покрывающий больше всего
+// непокрытых работ. Не больше чем в ln(число работ) + 1 раз хуже оптимума.
+// Пусто, если покрытия нет.
+std::vector<size_t> FindGreedyTeam(const CoverageIndex& index);
+// Нижняя оценка по линейной релаксации. Двойственные веса работ сначала
+// поднимаются жадно, начиная с работ с наименьшим числом владельцев, затем
+// уточняются субградиентной оптимизацией лагранжиана. upperBound - размер
+// известной команды, по нему выбирается шаг и завершается поиск.
+size_t GetLowerBound(const CoverageIndex& index, size_t upperBound);
+// Жадная команда, улучшаемая локальным поиском: удаление лишних работников,
+// замена нескольких работников одним, случайная встряска с жадным
+// восстановлением. Останавливается, когда размер команды дошёл до нижней
+// оценки или истекло время. С bound улучшения передаются в bound, а поиск
+// заканчивается и при его остановке, и когда общая команда дошла до оценки.
+AnytimeTeam FindTeamAnytime(const CoverageIndex& index, std::chrono::milliseconds timeLimit,
+                            SharedBound* bound = nullptr);
+
+struct AnytimeWorkers
+{
+    std::vector<int> workers;
+    // Нет, если покрытия нет
+    std::optional<size_t> lowerBound;
+};
+
+// id работников по FindTeamAnytime или всех работников, если покрытия нет
+AnytimeWorkers GetMinWorkersAnytime(const std::vector<int>& works, const Workers& workers,
+                                    std::chrono::milliseconds timeLimit);
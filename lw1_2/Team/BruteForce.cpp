@@ -0,0 +1,309 @@
+#include "BruteForce.h"
+#include "RevolvingDoor.h"
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace
+{
+// Объединения масок префиксов команды, по GetWordCount() слов на префикс
+class MaskPrefixes
+{
+public:
+    MaskPrefixes(const CoverageIndex& index, size_t size)
+        : m_index(index),
+          m_prefixes((size + 1) * index.GetWordCount(), 0)
+    {
+    }
+
+    void Assign(size_t worker)
+    {
+        std::copy(m_index.GetMask(worker), m_index.GetMask(worker) + m_index.GetWordCount(), m_prefixes.begin());
+    }
+
+    void Unite(size_t position, size_t worker)
+    {
+        size_t wordCount = m_index.GetWordCount();
+        const Word* previous = m_prefixes.data() + (position - 1) * wordCount;
+        const Word* mask = m_index.GetMask(worker);
+        Word* prefix = m_prefixes.data() + position * wordCount;
+        for (size_t word = 0; word < wordCount; word++)
+        {
+            prefix[word] = previous[word] | mask[word];
+        }
+    }
+
+    bool IsCovering(size_t position) const
+    {
+        return m_index.IsCovering(m_prefixes.data() + position * m_index.GetWordCount());
+    }
+
+private:
+    const CoverageIndex& m_index;
+    std::vector<Word> m_prefixes;
+};
+
+// То же над сжатыми картами: объединение обходит контейнеры навыков, а не
+// весь каталог работ
+class BitmapPrefixes
+{
+public:
+    BitmapPrefixes(const CoverageIndex& index, size_t size)
+        : m_index(index),
+          m_prefixes(size + 1)
+    {
+    }
+
+    void Assign(size_t worker)
+    {
+        m_prefixes[0] = m_index.GetBitmap(worker);
+    }
+
+    void Unite(size_t position, size_t worker)
+    {
+        m_prefixes[position] = m_prefixes[position - 1];
+        m_prefixes[position].UnionWith(m_index.GetBitmap(worker));
+    }
+
+    bool IsCovering(size_t position) const
+    {
+        return m_index.IsCovering(m_prefixes[position]);
+    }
+
+private:
+    const CoverageIndex& m_index;
+    std::vector<CompressedBitmap> m_prefixes;
+};
+
+template <typename Prefixes>
+std::vector<size_t> SearchTeamOfSize(const CoverageIndex& index, size_t size, std::optional<size_t> member,
+                                     const SharedBound* bound)
+{
+    size_t workersNumber = index.GetWorkerCount();
+    // Если член команды задан, перебираются остальные, номера после него сдвинуты на один
+    size_t dim = member ? workersNumber - 1 : workersNumber;
+    size_t currentSize = member ? size - 1 : size;
+    std::vector<size_t> combination(currentSize + 1);
+    for (size_t i = 1; i <= currentSize; i++)
+    {
+        combination[i] = i;
+    }
+    // Префикс i - объединение работников на позициях 1..i и члена команды
+    Prefixes prefixes(index, currentSize);
+    if (member)
+    {
+        prefixes.Assign(*member);
+    }
+    auto getWorker = [&](size_t element) {
+        return member && element - 1 >= *member ? element : element - 1;
+    };
+
+    size_t changed = 1;
+    do
+    {
+        // Общий рекорд не больше size - команда этого размера его не улучшит
+        if (bound != nullptr && (bound->IsStopped() || bound->GetSize() <= size))
+        {
+            return {};
+        }
+        for (size_t i = changed; i <= currentSize; i++)
+        {
+            prefixes.Unite(i, getWorker(combination[i]));
+        }
+        if (prefixes.IsCovering(currentSize))
+        {
+            std::vector<size_t> team;
+            for (size_t i = 1; i <= currentSize; i++)
+            {
+                team.push_back(getWorker(combination[i]));
+            }
+            if (member)
+            {
+                team.insert(std::upper_bound(team.begin(), team.end(), *member), *member);
+            }
+            return team;
+        }
+    } while (NextCombinations(dim, combination, changed));
+    return {};
+}
+}
+
+std::vector<size_t> FindTeamOfSize(const CoverageIndex& index, size_t size, std::optional<size_t> member,
+                                   const SharedBound* bound)
+{
+    if (size == 0 || size > index.GetWorkerCount())
+    {
+        return {};
+    }
+    return index.HasMasks() ? SearchTeamOfSize<MaskPrefixes>(index, size, member, bound)
+                            : SearchTeamOfSize<BitmapPrefixes>(index, size, member, bound);
+}
+
+std::vector<size_t> FindMinTeamLexicographic(const CoverageIndex& index)
+{
+    for (size_t currentSize = 1; currentSize <= index.GetWorkerCount(); currentSize++)
+    {
+        auto team = FindTeamOfSize(index, currentSize);
+        if (!team.empty())
+        {
+            return team;
+        }
+    }
+    return {};
+}
+
+// Порядок вращающейся двери не лексикографический, поэтому размер обходится
+// целиком, и из покрывающих команд выбирается лексикографически первая
+std::vector<size_t> FindMinTeamRevolvingDoor(const CoverageIndex& index)
+{
+    size_t workersNumber = index.GetWorkerCount();
+    CoverageCounter counter(index);
+    std::vector<size_t> best(workersNumber);
+    for (size_t currentSize = 1; currentSize <= workersNumber; currentSize++)
+    {
+        RevolvingDoor combinations(workersNumber, currentSize);
+        const size_t* team = combinations.GetCombination();
+        counter.Clear();
+        for (size_t i = 0; i < currentSize; i++)
+        {
+            counter.Add(team[i]);
+        }
+
+        bool found = false;
+        size_t removed;
+        size_t added;
+        while (true)
+        {
+            if (counter.IsCovered()
+                && (!found || std::lexicographical_compare(team, team + currentSize,
+                                                           best.data(), best.data() + currentSize)))
+            {
+                std::copy(team, team + currentSize, best.begin());
+                found = true;
+            }
+            if (!combinations.Next(removed, added))
+            {
+                break;
+            }
+            counter.Remove(removed);
+            counter.Add(added);
+        }
+        if (found)
+        {
+            best.resize(currentSize);
+            return best;
+        }
+    }
+    return {};
+}
+
+// Шаг лексикографического перебора обходит в среднем около одной маски,
+// шаг вращающейся двери - навыки двух работников, но доходит до конца размера
+EnumerationOrder SelectEnumerationOrder(const CoverageIndex& index)
+{
+    size_t workersNumber = std::max<size_t>(index.GetWorkerCount(), 1);
+    size_t averageSkills = index.GetSkillCount() / workersNumber;
+    return 4 * averageSkills < index.GetWordCount() ? EnumerationOrder::RevolvingDoor
+                                                    : EnumerationOrder::Lexicographic;
+}
+
+MinTeam FindMinTeam(const CoverageIndex& index, EnumerationOrder order)
+{
+    if (!index.IsCoverable())
+    {
+        return std::nullopt;
+    }
+    if (index.GetWorkCount() == 0)
+    {
+        return std::vector<size_t>{};
+    }
+    if (order == EnumerationOrder::RevolvingDoor)
+    {
+        return FindMinTeamRevolvingDoor(index);
+    }
+    return FindMinTeamLexicographic(index);
+}
+
+std::vector<int> GetMinWorkers(const std::vector<int>& works, const Workers& workers)
+{
+    CoverageIndex index(works, workers);
+    return GetWorkerIds(index, FindMinTeam(index, SelectEnumerationOrder(index)));
+}
+
+bool NextCombinations(size_t dim, std::vector<size_t>& state, size_t& changed)
+{
+    size_t k = state.size() - 1;
+    size_t m = k;
+    while (m > 0 && state[m] == dim - k + m)
+    {
+        m = m - 1;
+    }
+    if (m == 0)
+    {
+        return false;
+    }
+    state[m] = state[m] + 1;
+    for (size_t i = m + 1; i <= k; i++)
+    {
+        state[i] = state[i - 1] + 1;
+    }
+    changed = m;
+    return true;
+}
+
+std::uint64_t GetBinomial(size_t n, size_t k)
+{
+    if (k > n)
+    {
+        return 0;
+    }
+    k = std::min(k, n - k);
+    std::uint64_t result = 1;
+    for (size_t i = 1; i <= k; i++)
+    {
+        // result * (n - k + i) / i делится нацело, так как result = C(n - k + i - 1, i - 1)
+        unsigned __int128 next = static_cast<unsigned __int128>(result) * (n - k + i) / i;
+        if (next > UINT64_MAX)
+        {
+            throw std::overflow_error("Too many combinations");
+        }
+        result = static_cast<std::uint64_t>(next);
+    }
+    return result;
+}
+
+// Сочетания с первым элементом меньше c_1 идут раньше, затем среди
+// начинающихся с c_1 - с меньшим вторым и так далее. Остаток после
+// i-го элемента считается через дополнение: C(n - 1 - c_i, k - i + 1)
+// сочетаний начинаются не раньше c_i + 1.
+std::uint64_t RankCombination(size_t n, const std::vector<size_t>& combination)
+{
+    size_t k = combination.size();
+    std::uint64_t rank = GetBinomial(n, k) - 1;
+    for (size_t i = 0; i < k; i++)
+    {
+        rank -= GetBinomial(n - 1 - combination[i], k - i);
+    }
+    return rank;
+}
+
+std::vector<size_t> UnrankCombination(size_t n, size_t k, std::uint64_t rank)
+{
+    std::vector<size_t> combination(k);
+    size_t element = 0;
+    for (size_t i = 0; i < k; i++)
+    {
+        while (true)
+        {
+            std::uint64_t count = GetBinomial(n - 1 - element, k - 1 - i);
+            if (rank < count)
+            {
+                break;
+            }
+            rank -= count;
+            element++;
+        }
+        combination[i] = element++;
+    }
+    return combination;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "Coverage.h"
+#include "SharedBound.h"
+#include <optional>
+
+
+// Порядок перебора сочетаний одного размера
+enum class EnumerationOrder
+{
+    // Лексикографический: маски префиксов команды пересчитываются начиная
+    // с первой изменившейся позиции
+    Lexicographic,
+    // Вращающаяся дверь: счётчики покрытия обновляются по навыкам вышедшего
+    // и вошедшего работника. Выгоднее, когда маски намного длиннее списков навыков.
+    RevolvingDoor,
+};
+
+// Следующее сочетание из dim по state.size() - 1, элементы state[1..k]
+// нумеруются с единицы, changed - первая изменившаяся позиция.
+// false, если сочетание было последним.
+bool NextCombinations(size_t dim, std::vector<size_t>& state, size_t& changed);
+// Число сочетаний из n по k. std::overflow_error, если оно не помещается в 64 бита.
+std::uint64_t GetBinomial(size_t n, size_t k);
+// Номер сочетания (элементы с нуля, по возрастанию) среди сочетаний из n
+// в порядке NextCombinations
+std::uint64_t RankCombination(size_t n, const std::vector<size_t>& combination);
+// Сочетание из n по k с номером rank, обратное к RankCombination
+std::vector<size_t> UnrankCombination(size_t n, size_t k, std::uint64_t rank);
+EnumerationOrder SelectEnumerationOrder(const CoverageIndex& index);
+// Лексикографически первая покрывающая команда ровно из size работников.
+// Если задан member, перебираются только команды с ним: их лексикографический
+// порядок совпадает с порядком остальных членов. Пусто, если такой нет или
+// перебор прерван: bound остановлен либо нашёл команду не больше size.
+std::vector<size_t> FindTeamOfSize(const CoverageIndex& index, size_t size,
+                                   std::optional<size_t> member = std::nullopt,
+                                   const SharedBound* bound = nullptr);
+// Лексикографически первая среди команд наименьшего размера, покрывающих все
+// работы (плотные номера). Результат не зависит от order.
+MinTeam FindMinTeam(const CoverageIndex& index, EnumerationOrder order);
+// Перебор сочетаний работников по возрастанию размера. Возвращает id первой
+// найденной команды, покрывающей все работы (пусто, если работ нет), или всех
+// работников, если покрытия нет.
+std::vector<int> GetMinWorkers(const std::vector<int>& works, const Workers& workers);
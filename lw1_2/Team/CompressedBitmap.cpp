@@ -0,0 +1,411 @@
+#include "CompressedBitmap.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iterator>
+
+
+namespace
+{
+const std::uint32_t CHUNK_BITS = 16;
+const std::uint32_t CHUNK_SIZE = 1u << CHUNK_BITS;
+const size_t CHUNK_WORDS = CHUNK_SIZE / 64;
+// Больше этого массив занимает не меньше битовой карты
+const size_t ARRAY_MAX_SIZE = 4096;
+
+using ChunkWords = std::array<std::uint64_t, CHUNK_WORDS>;
+
+// Биты отрезка [first, last], попадающие в слово word
+std::uint64_t GetRangeMask(std::uint32_t word, std::uint32_t first, std::uint32_t last)
+{
+    std::uint32_t low = word == first / 64 ? first % 64 : 0;
+    std::uint32_t high = word == last / 64 ? last % 64 : 63;
+    return (UINT64_MAX >> (63 - high)) & (UINT64_MAX << low);
+}
+}
+
+CompressedBitmap CompressedBitmap::FromSorted(std::span<const std::uint32_t> values)
+{
+    CompressedBitmap bitmap;
+    std::vector<std::uint16_t> lowBits;
+    for (size_t begin = 0; begin < values.size();)
+    {
+        std::uint32_t key = values[begin] >> CHUNK_BITS;
+        lowBits.clear();
+        size_t end = begin;
+        for (; end < values.size() && values[end] >> CHUNK_BITS == key; end++)
+        {
+            lowBits.push_back(static_cast<std::uint16_t>(values[end]));
+        }
+        bitmap.m_containers.push_back(MakeContainer(static_cast<std::uint16_t>(key), lowBits));
+        begin = end;
+    }
+    return bitmap;
+}
+
+CompressedBitmap CompressedBitmap::FromRange(std::uint32_t begin, std::uint32_t end)
+{
+    CompressedBitmap bitmap;
+    if (begin >= end)
+    {
+        return bitmap;
+    }
+    std::uint32_t last = end - 1;
+    for (std::uint32_t key = begin >> CHUNK_BITS; key <= last >> CHUNK_BITS; key++)
+    {
+        std::uint32_t first = key == begin >> CHUNK_BITS ? begin % CHUNK_SIZE : 0;
+        std::uint32_t high = key == last >> CHUNK_BITS ? last % CHUNK_SIZE : CHUNK_SIZE - 1;
+        Container container{static_cast<std::uint16_t>(key), ContainerType::Run, high - first + 1, {}, {}, {}};
+        container.runs.push_back({static_cast<std::uint16_t>(first), static_cast<std::uint16_t>(high - first)});
+        bitmap.m_containers.push_back(std::move(container));
+    }
+    return bitmap;
+}
+
+CompressedBitmap CompressedBitmap::UnionOf(std::span<const CompressedBitmap* const> bitmaps)
+{
+    std::vector<const Container*> containers;
+    for (const CompressedBitmap* bitmap : bitmaps)
+    {
+        for (const auto& container : bitmap->m_containers)
+        {
+            containers.push_back(&container);
+        }
+    }
+    std::stable_sort(containers.begin(), containers.end(), [](const Container* left, const Container* right) {
+        return left->key < right->key;
+    });
+
+    CompressedBitmap united;
+    for (size_t begin = 0; begin < containers.size();)
+    {
+        size_t end = begin + 1;
+        while (end < containers.size() && containers[end]->key == containers[begin]->key)
+        {
+            end++;
+        }
+        if (end - begin == 1)
+        {
+            united.m_containers.push_back(*containers[begin]);
+        }
+        else
+        {
+            Container container{containers[begin]->key, ContainerType::Bitmap, 0, {}, {}, {}};
+            container.words.assign(CHUNK_WORDS, 0);
+            for (size_t i = begin; i < end && container.cardinality < CHUNK_SIZE; i++)
+            {
+                container.cardinality += ToWords(*containers[i], container.words.data());
+            }
+            Normalize(container);
+            united.m_containers.push_back(std::move(container));
+        }
+        begin = end;
+    }
+    return united;
+}
+
+void CompressedBitmap::UnionWith(const CompressedBitmap& other)
+{
+    if (other.m_containers.empty())
+    {
+        return;
+    }
+    if (m_containers.empty())
+    {
+        m_containers = other.m_containers;
+        return;
+    }
+    std::vector<Container> containers;
+    containers.reserve(m_containers.size() + other.m_containers.size());
+    auto current = m_containers.begin();
+    auto added = other.m_containers.begin();
+    while (current != m_containers.end() || added != other.m_containers.end())
+    {
+        if (added == other.m_containers.end() || (current != m_containers.end() && current->key < added->key))
+        {
+            containers.push_back(std::move(*current++));
+        }
+        else if (current == m_containers.end() || added->key < current->key)
+        {
+            containers.push_back(*added++);
+        }
+        else
+        {
+            Unite(*current, *added++);
+            containers.push_back(std::move(*current++));
+        }
+    }
+    m_containers = std::move(containers);
+}
+
+bool CompressedBitmap::Contains(const CompressedBitmap& other) const
+{
+    auto current = m_containers.begin();
+    for (const auto& container : other.m_containers)
+    {
+        while (current != m_containers.end() && current->key < container.key)
+        {
+            ++current;
+        }
+        if (current == m_containers.end() || current->key != container.key || !Includes(*current, container))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CompressedBitmap::Contains(std::uint32_t value) const
+{
+    auto key = static_cast<std::uint16_t>(value >> CHUNK_BITS);
+    auto container = std::lower_bound(m_containers.begin(), m_containers.end(), key,
+                                      [](const Container& container, std::uint16_t key) {
+                                          return container.key < key;
+                                      });
+    return container != m_containers.end() && container->key == key
+        && ContainsValue(*container, static_cast<std::uint16_t>(value));
+}
+
+std::uint64_t CompressedBitmap::GetCardinality() const
+{
+    std::uint64_t cardinality = 0;
+    for (const auto& container : m_containers)
+    {
+        cardinality += container.cardinality;
+    }
+    return cardinality;
+}
+
+size_t CompressedBitmap::GetSizeInBytes() const
+{
+    size_t size = m_containers.capacity() * sizeof(Container);
+    for (const auto& container : m_containers)
+    {
+        size += container.values.capacity() * sizeof(std::uint16_t)
+            + container.words.capacity() * sizeof(std::uint64_t)
+            + container.runs.capacity() * sizeof(Run);
+    }
+    return size;
+}
+
+CompressedBitmap::Container CompressedBitmap::MakeContainer(std::uint16_t key,
+                                                            std::span<const std::uint16_t> values)
+{
+    size_t runCount = 0;
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        runCount += i == 0 || values[i] != values[i - 1] + 1;
+    }
+    Container container{key, ContainerType::Array, static_cast<std::uint32_t>(values.size()), {}, {}, {}};
+    size_t arrayBytes = values.size() * sizeof(std::uint16_t);
+    size_t runBytes = runCount * sizeof(Run);
+    size_t bitmapBytes = CHUNK_WORDS * sizeof(std::uint64_t);
+    if (runBytes < std::min(arrayBytes, bitmapBytes))
+    {
+        container.type = ContainerType::Run;
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            if (i == 0 || values[i] != values[i - 1] + 1)
+            {
+                container.runs.push_back({values[i], 0});
+            }
+            else
+            {
+                container.runs.back().length++;
+            }
+        }
+    }
+    else if (values.size() <= ARRAY_MAX_SIZE)
+    {
+        container.values.assign(values.begin(), values.end());
+    }
+    else
+    {
+        container.type = ContainerType::Bitmap;
+        container.words.assign(CHUNK_WORDS, 0);
+        for (std::uint16_t value : values)
+        {
+            container.words[value / 64] |= std::uint64_t(1) << (value % 64);
+        }
+    }
+    return container;
+}
+
+std::uint32_t CompressedBitmap::ToWords(const Container& container, std::uint64_t* words)
+{
+    std::uint32_t added = 0;
+    switch (container.type)
+    {
+    case ContainerType::Array:
+        for (std::uint16_t value : container.values)
+        {
+            std::uint64_t bit = std::uint64_t(1) << (value % 64);
+            added += (words[value / 64] & bit) == 0;
+            words[value / 64] |= bit;
+        }
+        break;
+    case ContainerType::Bitmap:
+        for (size_t word = 0; word < CHUNK_WORDS; word++)
+        {
+            added += std::popcount(container.words[word] & ~words[word]);
+            words[word] |= container.words[word];
+        }
+        break;
+    case ContainerType::Run:
+        for (const auto& run : container.runs)
+        {
+            std::uint32_t first = run.start;
+            std::uint32_t last = first + run.length;
+            for (std::uint32_t word = first / 64; word <= last / 64; word++)
+            {
+                std::uint64_t range = GetRangeMask(word, first, last);
+                added += std::popcount(range & ~words[word]);
+                words[word] |= range;
+            }
+        }
+        break;
+    }
+    return added;
+}
+
+// Битовая карта после объединения остаётся картой, как в Roaring: серии
+// пересчитываются только для заполненного блока, а массив нужен, пока
+// элементов мало
+void CompressedBitmap::Normalize(Container& container)
+{
+    std::uint32_t cardinality = container.cardinality;
+    if (cardinality == CHUNK_SIZE)
+    {
+        container.words.clear();
+        container.type = ContainerType::Run;
+        container.runs.push_back({0, CHUNK_SIZE - 1});
+    }
+    else if (cardinality <= ARRAY_MAX_SIZE)
+    {
+        std::vector<std::uint16_t> values;
+        values.reserve(cardinality);
+        for (size_t word = 0; word < CHUNK_WORDS; word++)
+        {
+            for (std::uint64_t bits = container.words[word]; bits != 0; bits &= bits - 1)
+            {
+                values.push_back(static_cast<std::uint16_t>(word * 64 + std::countr_zero(bits)));
+            }
+        }
+        container = MakeContainer(container.key, values);
+    }
+}
+
+void CompressedBitmap::Unite(Container& container, const Container& other)
+{
+    if (container.cardinality == CHUNK_SIZE)
+    {
+        return;
+    }
+    if (container.type == ContainerType::Array && other.type == ContainerType::Array
+        && container.values.size() + other.values.size() <= ARRAY_MAX_SIZE)
+    {
+        std::vector<std::uint16_t> values;
+        values.reserve(container.values.size() + other.values.size());
+        std::set_union(container.values.begin(), container.values.end(), other.values.begin(), other.values.end(),
+                       std::back_inserter(values));
+        container.cardinality = static_cast<std::uint32_t>(values.size());
+        container.values = std::move(values);
+        return;
+    }
+    if (container.type != ContainerType::Bitmap)
+    {
+        std::vector<std::uint64_t> words(CHUNK_WORDS, 0);
+        ToWords(container, words.data());
+        container.values.clear();
+        container.runs.clear();
+        container.words = std::move(words);
+        container.type = ContainerType::Bitmap;
+    }
+    container.cardinality += ToWords(other, container.words.data());
+    Normalize(container);
+}
+
+bool CompressedBitmap::Includes(const Container& container, const Container& other)
+{
+    if (other.cardinality > container.cardinality)
+    {
+        return false;
+    }
+    switch (other.type)
+    {
+    case ContainerType::Array:
+        if (container.type == ContainerType::Array)
+        {
+            return std::includes(container.values.begin(), container.values.end(), other.values.begin(),
+                                 other.values.end());
+        }
+        return std::all_of(other.values.begin(), other.values.end(), [&](std::uint16_t value) {
+            return ContainsValue(container, value);
+        });
+    case ContainerType::Run:
+        return std::all_of(other.runs.begin(), other.runs.end(), [&](const Run& run) {
+            return IncludesRange(container, run.start, run.start + std::uint32_t(run.length));
+        });
+    case ContainerType::Bitmap:
+        break;
+    }
+    ChunkWords words{};
+    ToWords(container, words.data());
+    for (size_t word = 0; word < CHUNK_WORDS; word++)
+    {
+        if ((other.words[word] & ~words[word]) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CompressedBitmap::IncludesRange(const Container& container, std::uint32_t first, std::uint32_t last)
+{
+    switch (container.type)
+    {
+    case ContainerType::Array:
+    {
+        // Значения без повторов, поэтому весь отрезок есть, если на нужных
+        // местах стоят его концы
+        auto begin = std::lower_bound(container.values.begin(), container.values.end(), first);
+        size_t length = last - first;
+        return static_cast<size_t>(container.values.end() - begin) > length && *begin == first
+            && begin[length] == last;
+    }
+    case ContainerType::Bitmap:
+    {
+        for (std::uint32_t word = first / 64; word <= last / 64; word++)
+        {
+            std::uint64_t range = GetRangeMask(word, first, last);
+            if ((range & ~container.words[word]) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    case ContainerType::Run:
+    {
+        auto run = std::upper_bound(container.runs.begin(), container.runs.end(), first,
+                                    [](std::uint32_t value, const Run& run) { return value < run.start; });
+        return run != container.runs.begin() && std::prev(run)->start + std::uint32_t(std::prev(run)->length) >= last;
+    }
+    }
+    return false;
+}
+
+bool CompressedBitmap::ContainsValue(const Container& container, std::uint16_t value)
+{
+    switch (container.type)
+    {
+    case ContainerType::Array:
+        return std::binary_search(container.values.begin(), container.values.end(), value);
+    case ContainerType::Bitmap:
+        return (container.words[value / 64] >> (value % 64) & 1) != 0;
+    case ContainerType::Run:
+        return IncludesRange(container, value, value);
+    }
+    return false;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+
+// Сжатое множество 32-битных чисел в духе Roaring. Числа делятся на блоки по
+// старшим 16 битам, каждый блок хранится контейнером одного из видов:
+// - массив: отсортированные младшие 16 бит, пока их не больше 4096;
+// - битовая карта: 1024 слова по 64 бита;
+// - серии: отрезки [начало, начало + длина].
+// При построении вид выбирается по наименьшему размеру, поэтому память и время
+// операций растут с числом элементов и серий, а не с диапазоном значений.
+class CompressedBitmap
+{
+public:
+    CompressedBitmap() = default;
+    // values - по возрастанию без повторов
+    static CompressedBitmap FromSorted(std::span<const std::uint32_t> values);
+    // Все числа из [begin, end)
+    static CompressedBitmap FromRange(std::uint32_t begin, std::uint32_t end);
+
+    // Объединение многих карт: блоки с несколькими контейнерами собираются
+    // в одну битовую карту, без попарных слияний массивов
+    static CompressedBitmap UnionOf(std::span<const CompressedBitmap* const> bitmaps);
+
+    void UnionWith(const CompressedBitmap& other);
+    // Содержит ли множество все элементы other
+    bool Contains(const CompressedBitmap& other) const;
+    bool Contains(std::uint32_t value) const;
+    std::uint64_t GetCardinality() const;
+    // Байты, занятые контейнерами
+    size_t GetSizeInBytes() const;
+
+private:
+    enum class ContainerType
+    {
+        Array,
+        Bitmap,
+        Run,
+    };
+
+    struct Run
+    {
+        std::uint16_t start;
+        // Длина минус один, чтобы серия из 65536 чисел помещалась в 16 бит
+        std::uint16_t length;
+    };
+
+    struct Container
+    {
+        std::uint16_t key;
+        ContainerType type;
+        std::uint32_t cardinality;
+        std::vector<std::uint16_t> values;
+        std::vector<std::uint64_t> words;
+        std::vector<Run> runs;
+    };
+
+    static Container MakeContainer(std::uint16_t key, std::span<const std::uint16_t> values);
+    // Добавляет элементы контейнера к 1024 словам, возвращает число новых
+    static std::uint32_t ToWords(const Container& container, std::uint64_t* words);
+    static void Normalize(Container& container);
+    static void Unite(Container& container, const Container& other);
+    static bool Includes(const Container& container, const Container& other);
+    static bool IncludesRange(const Container& container, std::uint32_t first, std::uint32_t last);
+    static bool ContainsValue(const Container& container, std::uint16_t value);
+
+    // По возрастанию ключей
+    std::vector<Container> m_containers;
+};
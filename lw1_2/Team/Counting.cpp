@@ -0,0 +1,115 @@
+#include "Counting.h"
+#include "BruteForce.h"
+#include "DancingLinks.h"
+#include <algorithm>
+#include <bit>
+
+
+namespace
+{
+class InclusionExclusion
+{
+public:
+    explicit InclusionExclusion(const CoverageIndex& index)
+        : m_workersNumber(index.GetWorkerCount()),
+          m_wordCount((index.GetWorkerCount() + WORD_BITS - 1) / WORD_BITS)
+    {
+        auto owners = GetOwners(index);
+        for (size_t work : GetEssentialWorks(index))
+        {
+            m_owners.insert(m_owners.end(), owners.begin() + work * m_wordCount,
+                            owners.begin() + (work + 1) * m_wordCount);
+        }
+
+        m_unions.assign((GetWorkCount() + 1) * m_wordCount, 0);
+    }
+
+    // Работы, оставшиеся после отбрасывания покрываемых вместе с другими
+    size_t GetWorkCount() const
+    {
+        return m_wordCount == 0 ? 0 : m_owners.size() / m_wordCount;
+    }
+
+    // Сумма считается по модулю 2^64: итог не больше C(работники, size) и
+    // поэтому точен
+    std::uint64_t Count(size_t size)
+    {
+        m_size = size;
+        m_binomials.resize(m_workersNumber + 1);
+        for (size_t count = 0; count <= m_workersNumber; count++)
+        {
+            m_binomials[count] = GetBinomial(count, size);
+        }
+        m_total = m_binomials[m_workersNumber];
+        if (m_wordCount > 0)
+        {
+            Visit(0, 0, false);
+        }
+        return m_total;
+    }
+
+private:
+    // Добавляет к сумме наборы, полученные из текущего (объединение владельцев
+    // в m_unions[depth]) добавлением работ с номерами от first
+    void Visit(size_t first, size_t depth, bool isOdd)
+    {
+        size_t workCount = GetWorkCount();
+        const Word* current = m_unions.data() + depth * m_wordCount;
+        Word* next = m_unions.data() + (depth + 1) * m_wordCount;
+        for (size_t work = first; work < workCount; work++)
+        {
+            const Word* owners = m_owners.data() + work * m_wordCount;
+            size_t ownerCount = 0;
+            for (size_t word = 0; word < m_wordCount; word++)
+            {
+                next[word] = current[word] | owners[word];
+                ownerCount += std::popcount(next[word]);
+            }
+            size_t freeCount = m_workersNumber - ownerCount;
+            if (freeCount < m_size)
+            {
+                continue;
+            }
+            // Знак набора с этой работой противоположен знаку текущего
+            if (isOdd)
+            {
+                m_total += m_binomials[freeCount];
+            }
+            else
+            {
+                m_total -= m_binomials[freeCount];
+            }
+            Visit(work + 1, depth + 1, !isOdd);
+        }
+    }
+
+    size_t m_workersNumber;
+    size_t m_wordCount;
+    size_t m_size = 0;
+    std::vector<Word> m_owners;
+    std::vector<std::uint64_t> m_binomials;
+    // m_unions[depth] - объединение владельцев выбранных работ
+    std::vector<Word> m_unions;
+    std::uint64_t m_total = 0;
+};
+}
+
+std::uint64_t CountTeams(const CoverageIndex& index, size_t size)
+{
+    InclusionExclusion counter(index);
+    return counter.Count(size);
+}
+
+TeamCount CountMinTeams(const CoverageIndex& index)
+{
+    DancingLinks search(index);
+    InclusionExclusion counter(index);
+    if (counter.GetWorkCount() <= INCLUSION_EXCLUSION_MAX_WORKS)
+    {
+        auto team = search.FindMinTeam();
+        return team ? TeamCount{team->size(), counter.Count(team->size())} : TeamCount{0, 0};
+    }
+    TeamCount result{0, 0};
+    result.size = search.ForEachMinTeam([&](const std::vector<size_t>&) { result.count++; });
+    return result;
+}
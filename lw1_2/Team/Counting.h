@@ -0,0 +1,29 @@
+#pragma once
+#include "Coverage.h"
+
+
+// Больше работ после отбрасывания - наименьшие команды считаются перебором
+const size_t INCLUSION_EXCLUSION_MAX_WORKS = 24;
+
+struct TeamCount
+{
+    size_t size;
+    // 0, если покрытия нет. Без работ единственная наименьшая команда пуста.
+    std::uint64_t count;
+};
+
+// Число покрывающих команд ровно из size работников по формуле включений-
+// исключений: сумма по наборам работ S знакопеременных C(a(S), size), где
+// a(S) - число работников без работ из S. Работники без S - дополнение
+// объединения битовых множеств владельцев работ из S, их число считается
+// через popcount.
+//
+// В сумме участвуют только GetEssentialWorks.
+// Наборы, для которых a(S) < size, дают ноль вместе со всеми надмножествами
+// и не обходятся. std::overflow_error, если C(работники, size) не помещается
+// в 64 бита.
+std::uint64_t CountTeams(const CoverageIndex& index, size_t size);
+// Размер и число наименьших команд. Если после отбрасывания работ остаётся
+// не больше INCLUSION_EXCLUSION_MAX_WORKS, число считает CountTeams, иначе
+// подсчитываются команды DancingLinks::ForEachMinTeam.
+TeamCount CountMinTeams(const CoverageIndex& index);
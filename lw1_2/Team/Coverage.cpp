@@ -0,0 +1,598 @@
+#include "Coverage.h"
+#include <algorithm>
+#include <unordered_map>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TEAM_X86
+#endif
+
+
+bool IsCoveredSingleWord(const Word* masks, const Word* required, size_t,
+                         const size_t* team, size_t teamSize)
+{
+    Word covered = 0;
+    for (size_t i = 0; i < teamSize; i++)
+    {
+        covered |= masks[team[i]];
+    }
+    return covered == *required;
+}
+
+bool IsCoveredScalar(const Word* masks, const Word* required, size_t wordCount,
+                     const size_t* team, size_t teamSize)
+{
+    for (size_t word = 0; word < wordCount; word++)
+    {
+        Word covered = 0;
+        for (size_t i = 0; i < teamSize; i++)
+        {
+            covered |= masks[team[i] * wordCount + word];
+        }
+        if (covered != required[word])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef TEAM_X86
+
+__attribute__((target("avx2")))
+bool IsCoveredAvx2(const Word* masks, const Word* required, size_t wordCount,
+                   const size_t* team, size_t teamSize)
+{
+    for (size_t word = 0; word < wordCount; word += SIMD_WORDS)
+    {
+        __m256i covered = _mm256_setzero_si256();
+        for (size_t i = 0; i < teamSize; i++)
+        {
+            auto mask = reinterpret_cast<const __m256i*>(masks + team[i] * wordCount + word);
+            covered = _mm256_or_si256(covered, _mm256_loadu_si256(mask));
+        }
+        auto requiredWords = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(required + word));
+        if (!_mm256_testc_si256(covered, requiredWords))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
+
+CoverageIndex::CoverageIndex(const std::vector<int>& works, const Workers& workers, size_t maxMaskBytes)
+    : CoverageIndex(works, ToRoster(workers), maxMaskBytes)
+{
+}
+
+CoverageIndex::CoverageIndex(const std::vector<int>& works, const Roster& roster, size_t maxMaskBytes)
+    : m_maxMaskBytes(maxMaskBytes)
+{
+    for (int work : works)
+    {
+        if (m_workIndexes.emplace(work, m_works.size()).second)
+        {
+            m_works.push_back(work);
+        }
+    }
+
+    m_skillOffsets.push_back(0);
+    for (size_t worker = 0; worker < roster.GetWorkerCount(); worker++)
+    {
+        auto skills = GetDenseSkills(roster.GetSkills(worker));
+        m_skills.insert(m_skills.end(), skills.begin(), skills.end());
+        m_skillOffsets.push_back(m_skills.size());
+        m_workerIds.push_back(roster.ids[worker]);
+    }
+    StoreMasks();
+}
+
+size_t CoverageIndex::GetWorkerCount() const
+{
+    return m_workerIds.size();
+}
+
+size_t CoverageIndex::GetWorkCount() const
+{
+    return m_works.size();
+}
+
+size_t CoverageIndex::GetWordCount() const
+{
+    return m_wordCount;
+}
+
+int CoverageIndex::GetWorkerId(size_t worker) const
+{
+    return m_workerIds[worker];
+}
+
+const Word* CoverageIndex::GetMask(size_t worker) const
+{
+    return m_masks.data() + worker * m_wordCount;
+}
+
+const Word* CoverageIndex::GetRequiredMask() const
+{
+    return m_required.data();
+}
+
+bool CoverageIndex::HasMasks() const
+{
+    return m_hasMasks;
+}
+
+const CompressedBitmap& CoverageIndex::GetBitmap(size_t worker) const
+{
+    return m_bitmaps[worker];
+}
+
+const CompressedBitmap& CoverageIndex::GetRequiredBitmap() const
+{
+    return m_requiredBitmap;
+}
+
+std::span<const size_t> CoverageIndex::GetSkills(size_t worker) const
+{
+    return {m_skills.data() + m_skillOffsets[worker], m_skills.data() + m_skillOffsets[worker + 1]};
+}
+
+bool CoverageIndex::IsCovered(const size_t* team, size_t teamSize) const
+{
+    if (!m_hasMasks)
+    {
+        // Команда, у которой навыков меньше, чем работ, покрыть их не может
+        std::vector<const CompressedBitmap*> bitmaps;
+        size_t skillCount = 0;
+        for (size_t i = 0; i < teamSize; i++)
+        {
+            bitmaps.push_back(&m_bitmaps[team[i]]);
+            skillCount += m_skillOffsets[team[i] + 1] - m_skillOffsets[team[i]];
+        }
+        return skillCount >= m_works.size() && IsCovering(CompressedBitmap::UnionOf(bitmaps));
+    }
+    return m_isCovered(m_masks.data(), m_required.data(), m_wordCount, team, teamSize);
+}
+
+bool CoverageIndex::IsCovering(const Word* mask) const
+{
+    Word missing = 0;
+    for (size_t word = 0; word < m_wordCount; word++)
+    {
+        missing |= m_required[word] & ~mask[word];
+    }
+    return missing == 0;
+}
+
+bool CoverageIndex::IsCovering(const CompressedBitmap& bitmap) const
+{
+    return bitmap.Contains(m_requiredBitmap);
+}
+
+size_t CoverageIndex::GetSkillCount() const
+{
+    return m_skills.size();
+}
+
+bool CoverageIndex::IsCoverable() const
+{
+    std::vector<size_t> everyone(m_workerIds.size());
+    for (size_t worker = 0; worker < everyone.size(); worker++)
+    {
+        everyone[worker] = worker;
+    }
+    return IsCovered(everyone.data(), everyone.size());
+}
+
+void CoverageIndex::InsertWorker(size_t worker, int id, const std::vector<int>& skills)
+{
+    auto denseSkills = GetDenseSkills(skills);
+    size_t offset = m_skillOffsets[worker];
+    m_skills.insert(m_skills.begin() + offset, denseSkills.begin(), denseSkills.end());
+    m_skillOffsets.insert(m_skillOffsets.begin() + worker, offset);
+    for (size_t next = worker + 1; next < m_skillOffsets.size(); next++)
+    {
+        m_skillOffsets[next] += denseSkills.size();
+    }
+    m_workerIds.insert(m_workerIds.begin() + worker, id);
+
+    if (IsLayoutStale())
+    {
+        StoreMasks();
+    }
+    else if (m_hasMasks)
+    {
+        m_masks.insert(m_masks.begin() + worker * m_wordCount, m_wordCount, 0);
+        for (size_t work : denseSkills)
+        {
+            SetSkill(worker, work, true);
+        }
+    }
+    else
+    {
+        m_bitmaps.insert(m_bitmaps.begin() + worker, GetSkillBitmap(worker));
+    }
+}
+
+void CoverageIndex::EraseWorker(size_t worker)
+{
+    size_t skillCount = m_skillOffsets[worker + 1] - m_skillOffsets[worker];
+    m_skills.erase(m_skills.begin() + m_skillOffsets[worker], m_skills.begin() + m_skillOffsets[worker + 1]);
+    m_skillOffsets.erase(m_skillOffsets.begin() + worker + 1);
+    for (size_t next = worker + 1; next < m_skillOffsets.size(); next++)
+    {
+        m_skillOffsets[next] -= skillCount;
+    }
+    m_workerIds.erase(m_workerIds.begin() + worker);
+
+    if (IsLayoutStale())
+    {
+        StoreMasks();
+    }
+    else if (m_hasMasks)
+    {
+        auto row = m_masks.begin() + worker * m_wordCount;
+        m_masks.erase(row, row + m_wordCount);
+    }
+    else
+    {
+        m_bitmaps.erase(m_bitmaps.begin() + worker);
+    }
+}
+
+void CoverageIndex::AddSkill(size_t worker, int work)
+{
+    auto workIndex = m_workIndexes.find(work);
+    if (workIndex == m_workIndexes.end())
+    {
+        return;
+    }
+    auto begin = m_skills.begin() + m_skillOffsets[worker];
+    auto end = m_skills.begin() + m_skillOffsets[worker + 1];
+    auto position = std::lower_bound(begin, end, workIndex->second);
+    if (position != end && *position == workIndex->second)
+    {
+        return;
+    }
+    m_skills.insert(position, workIndex->second);
+    for (size_t next = worker + 1; next < m_skillOffsets.size(); next++)
+    {
+        m_skillOffsets[next]++;
+    }
+    SetSkill(worker, workIndex->second, true);
+}
+
+void CoverageIndex::RemoveSkill(size_t worker, int work)
+{
+    auto workIndex = m_workIndexes.find(work);
+    if (workIndex == m_workIndexes.end())
+    {
+        return;
+    }
+    auto begin = m_skills.begin() + m_skillOffsets[worker];
+    auto end = m_skills.begin() + m_skillOffsets[worker + 1];
+    auto position = std::lower_bound(begin, end, workIndex->second);
+    if (position == end || *position != workIndex->second)
+    {
+        return;
+    }
+    m_skills.erase(position);
+    for (size_t next = worker + 1; next < m_skillOffsets.size(); next++)
+    {
+        m_skillOffsets[next]--;
+    }
+    SetSkill(worker, workIndex->second, false);
+}
+
+// Новая работа получает последний плотный номер, поэтому в строках владельцев
+// она дописывается в конец
+void CoverageIndex::AddWork(int work, const std::vector<size_t>& owners)
+{
+    size_t workIndex = m_works.size();
+    if (!m_workIndexes.emplace(work, workIndex).second)
+    {
+        return;
+    }
+    m_works.push_back(work);
+
+    std::vector<size_t> skills;
+    skills.reserve(m_skills.size() + owners.size());
+    auto owner = owners.begin();
+    for (size_t worker = 0; worker < GetWorkerCount(); worker++)
+    {
+        size_t begin = m_skillOffsets[worker];
+        size_t end = m_skillOffsets[worker + 1];
+        m_skillOffsets[worker] = skills.size();
+        skills.insert(skills.end(), m_skills.begin() + begin, m_skills.begin() + end);
+        if (owner != owners.end() && *owner == worker)
+        {
+            skills.push_back(workIndex);
+            owner++;
+        }
+    }
+    m_skillOffsets.back() = skills.size();
+    m_skills = std::move(skills);
+
+    if (IsLayoutStale())
+    {
+        StoreMasks();
+        return;
+    }
+    if (m_hasMasks)
+    {
+        m_required[workIndex / WORD_BITS] |= Word(1) << (workIndex % WORD_BITS);
+    }
+    else
+    {
+        m_requiredBitmap = CompressedBitmap::FromRange(0, static_cast<std::uint32_t>(m_works.size()));
+    }
+    for (size_t worker : owners)
+    {
+        SetSkill(worker, workIndex, true);
+    }
+}
+
+void CoverageIndex::RemoveWork(int work)
+{
+    auto workIndex = m_workIndexes.find(work);
+    if (workIndex == m_workIndexes.end())
+    {
+        return;
+    }
+    size_t removed = workIndex->second;
+    size_t last = m_works.size() - 1;
+    m_workIndexes.erase(workIndex);
+    if (removed != last)
+    {
+        m_works[removed] = m_works[last];
+        m_workIndexes[m_works[removed]] = removed;
+    }
+    m_works.pop_back();
+
+    // Владельцы снятой работы теряют её, владельцы последней получают её номер
+    std::vector<size_t> changed;
+    size_t skillCount = 0;
+    for (size_t worker = 0; worker < GetWorkerCount(); worker++)
+    {
+        size_t begin = m_skillOffsets[worker];
+        size_t end = m_skillOffsets[worker + 1];
+        m_skillOffsets[worker] = skillCount;
+        bool isChanged = false;
+        for (size_t skill = begin; skill < end; skill++)
+        {
+            size_t skillWork = m_skills[skill];
+            if (skillWork == removed || skillWork == last)
+            {
+                isChanged = true;
+                if (skillWork == removed)
+                {
+                    continue;
+                }
+                skillWork = removed;
+            }
+            m_skills[skillCount++] = skillWork;
+        }
+        if (isChanged)
+        {
+            std::sort(m_skills.begin() + m_skillOffsets[worker], m_skills.begin() + skillCount);
+            changed.push_back(worker);
+        }
+    }
+    m_skillOffsets.back() = skillCount;
+    m_skills.resize(skillCount);
+
+    if (IsLayoutStale())
+    {
+        StoreMasks();
+        return;
+    }
+    if (m_hasMasks)
+    {
+        m_required[last / WORD_BITS] &= ~(Word(1) << (last % WORD_BITS));
+        for (size_t worker : changed)
+        {
+            const Word* mask = GetMask(worker);
+            bool isOwned = removed != last && (mask[last / WORD_BITS] >> (last % WORD_BITS)) & 1;
+            SetSkill(worker, last, false);
+            SetSkill(worker, removed, isOwned);
+        }
+    }
+    else
+    {
+        m_requiredBitmap = CompressedBitmap::FromRange(0, static_cast<std::uint32_t>(m_works.size()));
+        for (size_t worker : changed)
+        {
+            m_bitmaps[worker] = GetSkillBitmap(worker);
+        }
+    }
+}
+
+std::vector<size_t> CoverageIndex::GetDenseSkills(std::span<const int> skills) const
+{
+    std::vector<size_t> denseSkills;
+    for (int skill : skills)
+    {
+        auto work = m_workIndexes.find(skill);
+        if (work != m_workIndexes.end())
+        {
+            denseSkills.push_back(work->second);
+        }
+    }
+    std::sort(denseSkills.begin(), denseSkills.end());
+    denseSkills.erase(std::unique(denseSkills.begin(), denseSkills.end()), denseSkills.end());
+    return denseSkills;
+}
+
+CompressedBitmap CoverageIndex::GetSkillBitmap(size_t worker) const
+{
+    auto skills = GetSkills(worker);
+    return CompressedBitmap::FromSorted(std::vector<std::uint32_t>(skills.begin(), skills.end()));
+}
+
+// Меняет бит маски или перестраивает карту одного работника. Навыки в
+// m_skills к этому моменту уже обновлены.
+void CoverageIndex::SetSkill(size_t worker, size_t work, bool isOwned)
+{
+    if (!m_hasMasks)
+    {
+        m_bitmaps[worker] = GetSkillBitmap(worker);
+        return;
+    }
+    Word& word = m_masks[worker * m_wordCount + work / WORD_BITS];
+    Word bit = Word(1) << (work % WORD_BITS);
+    word = isOwned ? word | bit : word & ~bit;
+}
+
+// Раскладывает навыки по маскам или сжатым картам
+void CoverageIndex::StoreMasks()
+{
+    size_t wordCount = (m_works.size() + WORD_BITS - 1) / WORD_BITS;
+    m_wordCount = wordCount > 1 ? (wordCount + SIMD_WORDS - 1) / SIMD_WORDS * SIMD_WORDS : 1;
+    m_hasMasks = GetWorkerCount() * m_wordCount * sizeof(Word) <= m_maxMaskBytes;
+    m_masks.clear();
+    m_required.clear();
+    m_bitmaps.clear();
+    m_requiredBitmap = {};
+
+    if (m_hasMasks)
+    {
+        m_required.assign(m_wordCount, 0);
+        for (size_t work = 0; work < m_works.size(); work++)
+        {
+            m_required[work / WORD_BITS] |= Word(1) << (work % WORD_BITS);
+        }
+        m_masks.assign(GetWorkerCount() * m_wordCount, 0);
+        for (size_t worker = 0; worker < GetWorkerCount(); worker++)
+        {
+            for (size_t work : GetSkills(worker))
+            {
+                SetSkill(worker, work, true);
+            }
+        }
+    }
+    else
+    {
+        m_requiredBitmap = CompressedBitmap::FromRange(0, static_cast<std::uint32_t>(m_works.size()));
+        for (size_t worker = 0; worker < GetWorkerCount(); worker++)
+        {
+            m_bitmaps.push_back(GetSkillBitmap(worker));
+        }
+    }
+
+    m_isCovered = m_wordCount == 1 ? IsCoveredSingleWord : IsCoveredScalar;
+#ifdef TEAM_X86
+    __builtin_cpu_init();
+    if (m_wordCount > 1 && __builtin_cpu_supports("avx2"))
+    {
+        m_isCovered = IsCoveredAvx2;
+    }
+#endif
+}
+
+// Длина маски или способ хранения больше не соответствуют составу
+bool CoverageIndex::IsLayoutStale() const
+{
+    size_t wordCount = (m_works.size() + WORD_BITS - 1) / WORD_BITS;
+    size_t paddedCount = wordCount > 1 ? (wordCount + SIMD_WORDS - 1) / SIMD_WORDS * SIMD_WORDS : 1;
+    return paddedCount != m_wordCount
+        || m_hasMasks != (GetWorkerCount() * m_wordCount * sizeof(Word) <= m_maxMaskBytes);
+}
+
+std::vector<int> GetWorkerIds(const CoverageIndex& index, const MinTeam& team)
+{
+    std::vector<int> ids;
+    if (!team)
+    {
+        for (size_t worker = 0; worker < index.GetWorkerCount(); worker++)
+        {
+            ids.push_back(index.GetWorkerId(worker));
+        }
+        return ids;
+    }
+    for (size_t worker : *team)
+    {
+        ids.push_back(index.GetWorkerId(worker));
+    }
+    return ids;
+}
+
+std::vector<Word> GetOwners(const CoverageIndex& index)
+{
+    size_t wordCount = (index.GetWorkerCount() + WORD_BITS - 1) / WORD_BITS;
+    std::vector<Word> owners(index.GetWorkCount() * wordCount, 0);
+    for (size_t worker = 0; worker < index.GetWorkerCount(); worker++)
+    {
+        for (size_t work : index.GetSkills(worker))
+        {
+            owners[work * wordCount + worker / WORD_BITS] |= Word(1) << (worker % WORD_BITS);
+        }
+    }
+    return owners;
+}
+
+std::vector<size_t> GetEssentialWorks(const CoverageIndex& index)
+{
+    size_t wordCount = (index.GetWorkerCount() + WORD_BITS - 1) / WORD_BITS;
+    auto owners = GetOwners(index);
+    auto isSubset = [&](size_t subset, size_t set) {
+        for (size_t word = 0; word < wordCount; word++)
+        {
+            if ((owners[subset * wordCount + word] & ~owners[set * wordCount + word]) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<size_t> works;
+    for (size_t work = 0; work < index.GetWorkCount(); work++)
+    {
+        bool isImplied = false;
+        for (size_t other = 0; other < index.GetWorkCount() && !isImplied; other++)
+        {
+            isImplied = other != work && isSubset(other, work) && (other < work || !isSubset(work, other));
+        }
+        if (!isImplied)
+        {
+            works.push_back(work);
+        }
+    }
+    return works;
+}
+
+CoverageCounter::CoverageCounter(const CoverageIndex& index)
+    : m_index(index)
+    , m_counts(index.GetWorkCount(), 0)
+    , m_uncoveredCount(index.GetWorkCount())
+{
+}
+
+void CoverageCounter::Add(size_t worker)
+{
+    for (size_t work : m_index.GetSkills(worker))
+    {
+        m_uncoveredCount -= m_counts[work]++ == 0;
+    }
+}
+
+void CoverageCounter::Remove(size_t worker)
+{
+    for (size_t work : m_index.GetSkills(worker))
+    {
+        m_uncoveredCount += --m_counts[work] == 0;
+    }
+}
+
+bool CoverageCounter::IsCovered() const
+{
+    return m_uncoveredCount == 0;
+}
+
+void CoverageCounter::Clear()
+{
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_uncoveredCount = m_counts.size();
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include "CompressedBitmap.h"
+#include "Roster.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <unordered_map>
+
+
+using Word = std::uint64_t;
+
+const size_t WORD_BITS = 64;
+// Маски длиннее одного слова дополняются до ширины регистра AVX2
+const size_t SIMD_WORDS = 4;
+// Если плотные маски всех работников заняли бы больше, индекс хранит их
+// сжатыми битовыми картами
+const size_t DENSE_MASKS_MAX_BYTES = size_t(64) << 20;
+
+// Работники в виде битовых масок над плотными номерами требуемых работ.
+// Навыки, которых нет среди требуемых работ, на покрытие не влияют и отбрасываются.
+// Работники нумеруются по возрастанию id. При огромном каталоге работ и
+// редких навыках маски занимают слишком много памяти, тогда вместо них
+// хранятся сжатые битовые карты (HasMasks() == false), и проверка покрытия
+// объединяет карты команды.
+// Состав меняется на месте: затрагиваются строка работника или столбец
+// работы, а маски раскладываются заново, только когда меняется их длина.
+class CoverageIndex
+{
+public:
+    CoverageIndex(const std::vector<int>& works, const Workers& workers,
+                  size_t maxMaskBytes = DENSE_MASKS_MAX_BYTES);
+    CoverageIndex(const std::vector<int>& works, const Roster& roster,
+                  size_t maxMaskBytes = DENSE_MASKS_MAX_BYTES);
+
+    size_t GetWorkerCount() const;
+    size_t GetWorkCount() const;
+    // Длина плотной маски в словах, даже если маски не хранятся
+    size_t GetWordCount() const;
+    int GetWorkerId(size_t worker) const;
+    bool HasMasks() const;
+    // Только при HasMasks()
+    const Word* GetMask(size_t worker) const;
+    const Word* GetRequiredMask() const;
+    // Только без HasMasks()
+    const CompressedBitmap& GetBitmap(size_t worker) const;
+    const CompressedBitmap& GetRequiredBitmap() const;
+    // Плотные номера работ, которыми владеет работник, без повторов
+    std::span<const size_t> GetSkills(size_t worker) const;
+    // Покрывают ли работники team (плотные номера) все работы
+    bool IsCovered(const size_t* team, size_t teamSize) const;
+    bool IsCoverable() const;
+    // Содержит ли маска из GetWordCount() слов все работы
+    bool IsCovering(const Word* mask) const;
+    bool IsCovering(const CompressedBitmap& bitmap) const;
+    size_t GetSkillCount() const;
+
+    // worker - плотный номер нового работника, номера начиная с него сдвигаются
+    void InsertWorker(size_t worker, int id, const std::vector<int>& skills);
+    void EraseWorker(size_t worker);
+    // Навыки вне требуемых работ игнорируются
+    void AddSkill(size_t worker, int work);
+    void RemoveSkill(size_t worker, int work);
+    // owners - плотные номера владельцев работы по возрастанию
+    void AddWork(int work, const std::vector<size_t>& owners);
+    // Номер снятой работы переходит к последней работе
+    void RemoveWork(int work);
+
+private:
+    using CoverageCheck = bool (*)(const Word* masks, const Word* required, size_t wordCount,
+                                   const size_t* team, size_t teamSize);
+
+    std::vector<size_t> GetDenseSkills(std::span<const int> skills) const;
+    CompressedBitmap GetSkillBitmap(size_t worker) const;
+    void SetSkill(size_t worker, size_t work, bool isOwned);
+    void StoreMasks();
+    bool IsLayoutStale() const;
+
+    std::vector<int> m_workerIds;
+    // id работ по плотным номерам и обратно
+    std::vector<int> m_works;
+    std::unordered_map<int, size_t> m_workIndexes;
+    size_t m_maxMaskBytes = DENSE_MASKS_MAX_BYTES;
+    size_t m_wordCount = 1;
+    bool m_hasMasks = true;
+    std::vector<Word> m_masks;
+    std::vector<Word> m_required;
+    std::vector<CompressedBitmap> m_bitmaps;
+    CompressedBitmap m_requiredBitmap;
+    std::vector<size_t> m_skillOffsets;
+    std::vector<size_t> m_skills;
+    CoverageCheck m_isCovered;
+};
+
+// Наименьшая команда в плотных номерах по возрастанию или std::nullopt, если
+// покрытия нет. Пустая команда - ответ, когда работ нет.
+using MinTeam = std::optional<std::vector<size_t>>;
+
+// id работников команды team (плотные номера). Если покрытия нет,
+// возвращаются все работники.
+std::vector<int> GetWorkerIds(const CoverageIndex& index, const MinTeam& team);
+
+// Битовые множества владельцев работ: по (GetWorkerCount() + 63) / 64 слов на
+// работу, работа за работой
+std::vector<Word> GetOwners(const CoverageIndex& index);
+// Плотные номера работ по возрастанию без тех, что покрываются автоматически:
+// если владельцы работы включают всех владельцев другой работы, любая команда,
+// покрывшая другую, покрывает и её. Из работ с равными владельцами остаётся первая.
+std::vector<size_t> GetEssentialWorks(const CoverageIndex& index);
+
+// Сколько работников команды владеет каждой работой. Добавление и удаление
+// работника обходят только его навыки.
+class CoverageCounter
+{
+public:
+    explicit CoverageCounter(const CoverageIndex& index);
+
+    void Add(size_t worker);
+    void Remove(size_t worker);
+    bool IsCovered() const;
+    void Clear();
+
+private:
+    const CoverageIndex& m_index;
+    std::vector<unsigned> m_counts;
+    size_t m_uncoveredCount;
+};
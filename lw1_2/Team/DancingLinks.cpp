@@ -0,0 +1,254 @@
+#include "DancingLinks.h"
+#include "Anytime.h"
+#include <algorithm>
+
+
+DancingLinks::DancingLinks(const CoverageIndex& index)
+    : m_index(index)
+{
+    size_t workCount = index.GetWorkCount();
+    size_t workersNumber = index.GetWorkerCount();
+    size_t nodeCount = workCount + 1 + index.GetSkillCount();
+    m_left.resize(workCount + 1);
+    m_right.resize(workCount + 1);
+    m_up.resize(nodeCount);
+    m_down.resize(nodeCount);
+    m_column.resize(nodeCount);
+    m_row.resize(nodeCount);
+    m_sizes.assign(workCount + 1, 0);
+    m_covered.assign(workCount + 1, false);
+    m_rowStamps.assign(workersNumber, 0);
+    m_uncoveredCount = workCount;
+
+    for (size_t column = 0; column <= workCount; column++)
+    {
+        m_left[column] = column == 0 ? workCount : column - 1;
+        m_right[column] = column == workCount ? 0 : column + 1;
+        m_up[column] = column;
+        m_down[column] = column;
+        m_column[column] = column;
+    }
+
+    size_t node = workCount + 1;
+    m_rowOffsets.push_back(node);
+    for (size_t worker = 0; worker < workersNumber; worker++)
+    {
+        auto skills = index.GetSkills(worker);
+        m_maxRowSize = std::max(m_maxRowSize, skills.size());
+        for (size_t work : skills)
+        {
+            size_t column = work + 1;
+            m_column[node] = column;
+            m_row[node] = worker;
+            m_up[node] = m_up[column];
+            m_down[node] = column;
+            m_down[m_up[column]] = node;
+            m_up[column] = node;
+            m_sizes[column]++;
+            node++;
+        }
+        m_rowOffsets.push_back(node);
+    }
+}
+
+MinTeam DancingLinks::FindMinTeam(SharedBound* bound)
+{
+    if (!m_index.IsCoverable())
+    {
+        return std::nullopt;
+    }
+    m_best = FindGreedyTeam(m_index);
+    std::sort(m_best.begin(), m_best.end());
+    m_limit = m_best.size();
+    m_bound = bound;
+    if (m_bound != nullptr)
+    {
+        m_bound->Offer(m_best);
+    }
+    m_team.clear();
+    m_isInterrupted = false;
+    Search(0);
+    m_bound = nullptr;
+    std::sort(m_best.begin(), m_best.end());
+    return m_best;
+}
+
+bool DancingLinks::IsComplete() const
+{
+    return !m_isInterrupted;
+}
+
+size_t DancingLinks::ForEachMinTeam(const std::function<void(const std::vector<size_t>&)>& onTeam)
+{
+    auto best = FindMinTeam();
+    if (!best)
+    {
+        return 0;
+    }
+    // Ветви с i-м владельцем работы и без предыдущих не пересекаются,
+    // поэтому каждая команда встречается один раз
+    m_onTeam = &onTeam;
+    m_limit = best->size() + 1;
+    m_team.clear();
+    Search(0);
+    m_onTeam = nullptr;
+    return best->size();
+}
+
+void DancingLinks::Search(size_t depth)
+{
+    if (m_right[0] == 0)
+    {
+        if (m_onTeam != nullptr)
+        {
+            auto team = m_team;
+            std::sort(team.begin(), team.end());
+            (*m_onTeam)(team);
+            return;
+        }
+        m_best = m_team;
+        m_limit = depth;
+        if (m_bound != nullptr)
+        {
+            auto team = m_team;
+            std::sort(team.begin(), team.end());
+            m_bound->Offer(team);
+        }
+        return;
+    }
+    if (m_bound != nullptr)
+    {
+        if (m_bound->IsStopped())
+        {
+            m_isInterrupted = true;
+            return;
+        }
+        m_limit = std::min(m_limit, m_bound->GetSize());
+    }
+    if (depth + GetLowerBound() >= m_limit)
+    {
+        return;
+    }
+
+    size_t chosen = m_right[0];
+    for (size_t column = m_right[chosen]; column != 0; column = m_right[column])
+    {
+        if (m_sizes[column] < m_sizes[chosen])
+        {
+            chosen = column;
+        }
+    }
+    if (m_sizes[chosen] == 0)
+    {
+        return;
+    }
+
+    std::vector<size_t> candidates;
+    for (size_t node = m_down[chosen]; node != chosen; node = m_down[node])
+    {
+        candidates.push_back(m_row[node]);
+    }
+
+    std::vector<size_t> columns;
+    size_t excludedCount = 0;
+    for (size_t row : candidates)
+    {
+        for (size_t node = m_rowOffsets[row]; node < m_rowOffsets[row + 1]; node++)
+        {
+            if (!m_covered[m_column[node]])
+            {
+                CoverColumn(m_column[node]);
+                columns.push_back(m_column[node]);
+            }
+        }
+        m_team.push_back(row);
+        Search(depth + 1);
+        m_team.pop_back();
+        for (auto column = columns.rbegin(); column != columns.rend(); column++)
+        {
+            UncoverColumn(*column);
+        }
+        columns.clear();
+
+        // Команды с этим работником уже рассмотрены
+        ExcludeRow(row);
+        excludedCount++;
+        if (depth + 1 >= m_limit)
+        {
+            break;
+        }
+    }
+    while (excludedCount > 0)
+    {
+        RestoreRow(candidates[--excludedCount]);
+    }
+}
+
+// Непокрытые работы, никакие две из которых не покрываются одним оставшимся
+// работником, требуют разных работников
+size_t DancingLinks::GetLowerBound()
+{
+    m_stamp++;
+    size_t disjointCount = 0;
+    for (size_t column = m_right[0]; column != 0; column = m_right[column])
+    {
+        bool isDisjoint = true;
+        for (size_t node = m_down[column]; node != column && isDisjoint; node = m_down[node])
+        {
+            isDisjoint = m_rowStamps[m_row[node]] != m_stamp;
+        }
+        if (isDisjoint)
+        {
+            disjointCount++;
+            for (size_t node = m_down[column]; node != column; node = m_down[node])
+            {
+                m_rowStamps[m_row[node]] = m_stamp;
+            }
+        }
+    }
+    size_t sizeBound = (m_uncoveredCount + m_maxRowSize - 1) / m_maxRowSize;
+    return std::max(disjointCount, sizeBound);
+}
+
+void DancingLinks::CoverColumn(size_t column)
+{
+    m_right[m_left[column]] = m_right[column];
+    m_left[m_right[column]] = m_left[column];
+    m_covered[column] = true;
+    m_uncoveredCount--;
+}
+
+void DancingLinks::UncoverColumn(size_t column)
+{
+    m_right[m_left[column]] = column;
+    m_left[m_right[column]] = column;
+    m_covered[column] = false;
+    m_uncoveredCount++;
+}
+
+void DancingLinks::ExcludeRow(size_t row)
+{
+    for (size_t node = m_rowOffsets[row]; node < m_rowOffsets[row + 1]; node++)
+    {
+        m_down[m_up[node]] = m_down[node];
+        m_up[m_down[node]] = m_up[node];
+        m_sizes[m_column[node]]--;
+    }
+}
+
+void DancingLinks::RestoreRow(size_t row)
+{
+    for (size_t node = m_rowOffsets[row + 1]; node > m_rowOffsets[row]; node--)
+    {
+        m_down[m_up[node - 1]] = node - 1;
+        m_up[m_down[node - 1]] = node - 1;
+        m_sizes[m_column[node - 1]]++;
+    }
+}
+
+std::vector<int> GetMinWorkersDancingLinks(const std::vector<int>& works, const Workers& workers)
+{
+    CoverageIndex index(works, workers);
+    DancingLinks search(index);
+    return GetWorkerIds(index, search.FindMinTeam());
+}
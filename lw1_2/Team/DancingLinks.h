@@ -0,0 +1,73 @@
+#pragma once
+#include "Coverage.h"
+#include "SharedBound.h"
+#include <functional>
+
+
+// Точный поиск наименьшей команды методом ветвей и границ над разреженной
+// матрицей «работник × работа» в духе танцующих ссылок (Knuth, алгоритм X).
+// Столбцы - работы, строки - работники. В отличие от точного покрытия работы
+// могут покрываться несколько раз: выбранная строка снимает свои столбцы из
+// списка непокрытых, но не исключает другие строки.
+//
+// Ветвление идёт по работе, которой владеет меньше всего оставшихся работников:
+// в i-й ветви берётся i-й из них, а предыдущие исключаются. Ветвь отсекается,
+// если нижняя оценка (число попарно непересекающихся по работникам непокрытых
+// работ либо непокрытые работы, делённые на наибольшее число навыков) не даёт
+// улучшить рекорд. Начальный рекорд - жадная команда.
+class DancingLinks
+{
+public:
+    explicit DancingLinks(const CoverageIndex& index);
+
+    // Наименьшая команда (плотные номера по возрастанию).
+    // С bound рекордом служит и общая команда: ищутся только команды меньше
+    // неё, найденные передаются в bound. Если bound остановлен, поиск
+    // прерывается и возвращает лучшую из найденных им команд.
+    MinTeam FindMinTeam(SharedBound* bound = nullptr);
+    // Дошёл ли последний FindMinTeam до конца, не прерванный остановкой bound.
+    // Тогда команда в bound наименьшая.
+    bool IsComplete() const;
+    // Передаёт onTeam каждую наименьшую команду (плотные номера по
+    // возрастанию) по одному разу, не храня их. Возвращает размер команд.
+    // Если покрытия нет, возвращает 0 и onTeam не вызывается.
+    size_t ForEachMinTeam(const std::function<void(const std::vector<size_t>&)>& onTeam);
+
+private:
+    void Search(size_t depth);
+    size_t GetLowerBound();
+    void CoverColumn(size_t column);
+    void UncoverColumn(size_t column);
+    void ExcludeRow(size_t row);
+    void RestoreRow(size_t row);
+
+    const CoverageIndex& m_index;
+    // Узел 0 - корень списка непокрытых столбцов, 1..workCount - заголовки
+    std::vector<size_t> m_left;
+    std::vector<size_t> m_right;
+    std::vector<size_t> m_up;
+    std::vector<size_t> m_down;
+    std::vector<size_t> m_column;
+    std::vector<size_t> m_row;
+    std::vector<size_t> m_sizes;
+    // Узлы строки r занимают [m_rowOffsets[r], m_rowOffsets[r + 1])
+    std::vector<size_t> m_rowOffsets;
+    std::vector<bool> m_covered;
+    size_t m_uncoveredCount = 0;
+    size_t m_maxRowSize = 0;
+
+    std::vector<unsigned> m_rowStamps;
+    unsigned m_stamp = 0;
+
+    std::vector<size_t> m_team;
+    std::vector<size_t> m_best;
+    // Ветвь отсекается, если не даёт команды меньше m_limit
+    size_t m_limit = 0;
+    SharedBound* m_bound = nullptr;
+    bool m_isInterrupted = false;
+    const std::function<void(const std::vector<size_t>&)>* m_onTeam = nullptr;
+};
+
+// Наименьшая команда по DancingLinks. Возвращает id работников или всех
+// работников, если покрытия нет.
+std::vector<int> GetMinWorkersDancingLinks(const std::vector<int>& works, const Workers& workers);
@@ -0,0 +1,208 @@
+#include "Incremental.h"
+#include "BruteForce.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+
+TeamEngine::TeamEngine(const std::vector<int>& works, const Workers& workers)
+    : m_works(works.begin(), works.end()),
+      m_workers(workers),
+      m_index(std::make_unique<CoverageIndex>(std::vector<int>(m_works.begin(), m_works.end()), workers))
+{
+    SetTeam(FindMinTeam(*m_index, SelectEnumerationOrder(*m_index)));
+}
+
+void TeamEngine::AddWorker(int id, const std::vector<int>& skills)
+{
+    if (!m_workers.emplace(id, skills).second)
+    {
+        throw std::invalid_argument("Worker already exists: " + std::to_string(id));
+    }
+    m_index->InsertWorker(GetDenseIndex(id), id, skills);
+    SolveWith(id);
+}
+
+void TeamEngine::RemoveWorker(int id)
+{
+    auto worker = m_workers.find(id);
+    if (worker == m_workers.end())
+    {
+        throw std::invalid_argument("Unknown worker: " + std::to_string(id));
+    }
+    m_index->EraseWorker(GetDenseIndex(id));
+    m_workers.erase(worker);
+    if (m_team && std::find(m_team->begin(), m_team->end(), id) != m_team->end())
+    {
+        SolveFrom(m_team->size());
+    }
+}
+
+void TeamEngine::AddSkill(int id, int work)
+{
+    auto worker = m_workers.find(id);
+    if (worker == m_workers.end())
+    {
+        throw std::invalid_argument("Unknown worker: " + std::to_string(id));
+    }
+    auto& skills = worker->second;
+    if (std::find(skills.begin(), skills.end(), work) != skills.end())
+    {
+        return;
+    }
+    skills.push_back(work);
+    m_index->AddSkill(GetDenseIndex(id), work);
+    SolveWith(id);
+}
+
+void TeamEngine::RemoveSkill(int id, int work)
+{
+    auto worker = m_workers.find(id);
+    if (worker == m_workers.end())
+    {
+        throw std::invalid_argument("Unknown worker: " + std::to_string(id));
+    }
+    if (std::erase(worker->second, work) == 0)
+    {
+        return;
+    }
+    m_index->RemoveSkill(GetDenseIndex(id), work);
+    if (m_team && std::find(m_team->begin(), m_team->end(), id) != m_team->end() && !IsTeamCovering())
+    {
+        SolveFrom(m_team->size());
+    }
+}
+
+void TeamEngine::AddWork(int work)
+{
+    if (!m_works.insert(work).second)
+    {
+        return;
+    }
+    std::vector<size_t> owners;
+    size_t worker = 0;
+    for (const auto& [id, skills] : m_workers)
+    {
+        if (std::find(skills.begin(), skills.end(), work) != skills.end())
+        {
+            owners.push_back(worker);
+        }
+        worker++;
+    }
+    m_index->AddWork(work, owners);
+    if (m_team && !IsTeamCovering())
+    {
+        SolveFrom(m_team->size());
+    }
+}
+
+// Команда без снятой работы и любой её владелец покрывают прежние работы,
+// поэтому оптимум уменьшается не больше чем на один
+void TeamEngine::RemoveWork(int work)
+{
+    if (m_works.erase(work) == 0)
+    {
+        return;
+    }
+    m_index->RemoveWork(work);
+    // Команда из одного работника могла стать пустой, это проверяет SolveFrom
+    if (!m_team || m_team->size() <= 1)
+    {
+        SolveFrom(1);
+        return;
+    }
+    size_t size = m_team->size();
+    auto team = FindTeamOfSize(*m_index, size - 1);
+    SetTeam(team.empty() ? FindTeamOfSize(*m_index, size) : team);
+}
+
+std::vector<int> TeamEngine::GetTeam() const
+{
+    return m_team ? *m_team : GetKeys(m_workers);
+}
+
+void TeamEngine::SolveFrom(size_t size)
+{
+    m_team.reset();
+    if (!m_index->IsCoverable())
+    {
+        return;
+    }
+    if (m_index->GetWorkCount() == 0)
+    {
+        m_team.emplace();
+        return;
+    }
+    for (size_t currentSize = std::max<size_t>(size, 1); currentSize <= m_index->GetWorkerCount(); currentSize++)
+    {
+        auto team = FindTeamOfSize(*m_index, currentSize);
+        if (!team.empty())
+        {
+            SetTeam(team);
+            return;
+        }
+    }
+}
+
+// Покрытий прибавилось только за счёт работника id. Команды меньше прежней
+// обязаны его содержать, а среди команд прежнего размера первая - либо
+// прежняя, либо первая с ним.
+void TeamEngine::SolveWith(int id)
+{
+    if (!m_team)
+    {
+        SolveFrom(1);
+        return;
+    }
+    size_t worker = GetDenseIndex(id);
+    size_t size = m_team->size();
+    for (size_t currentSize = 1; currentSize < size; currentSize++)
+    {
+        auto team = FindTeamOfSize(*m_index, currentSize, worker);
+        if (!team.empty())
+        {
+            SetTeam(team);
+            return;
+        }
+    }
+    auto team = FindTeamOfSize(*m_index, size, worker);
+    auto current = GetDenseTeam();
+    if (!team.empty() && std::lexicographical_compare(team.begin(), team.end(), current.begin(), current.end()))
+    {
+        SetTeam(team);
+    }
+}
+
+size_t TeamEngine::GetDenseIndex(int id) const
+{
+    return static_cast<size_t>(std::distance(m_workers.begin(), m_workers.find(id)));
+}
+
+std::vector<size_t> TeamEngine::GetDenseTeam() const
+{
+    std::vector<size_t> team;
+    for (int id : *m_team)
+    {
+        team.push_back(GetDenseIndex(id));
+    }
+    return team;
+}
+
+void TeamEngine::SetTeam(const MinTeam& team)
+{
+    m_team.reset();
+    if (team)
+    {
+        m_team.emplace();
+        for (size_t worker : *team)
+        {
+            m_team->push_back(m_index->GetWorkerId(worker));
+        }
+    }
+}
+
+bool TeamEngine::IsTeamCovering() const
+{
+    auto team = GetDenseTeam();
+    return m_index->IsCovered(team.data(), team.size());
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "Coverage.h"
+#include <memory>
+#include <set>
+
+
+// Наименьшая команда, пересчитываемая после каждого изменения состава.
+// Хранит работы, работников, индекс покрытия и текущую команду. Индекс
+// обновляется на месте, без перестроения. Команда
+// всегда совпадает с тем, что вернул бы GetMinWorkers с нуля (лексикографически
+// первая среди наименьших), но поиск начинается с прежнего размера k:
+// - новые работник, навык или снятая работа не могут увеличить оптимум:
+//   проверяются меньшие размеры, а для добавленного работника - только
+//   команды с ним;
+// - удалённые работник, навык или новая работа не уменьшают оптимум: если
+//   прежняя команда их не затрагивает, она остаётся ответом, иначе перебор
+//   идёт с размера k.
+class TeamEngine
+{
+public:
+    TeamEngine(const std::vector<int>& works, const Workers& workers);
+
+    void AddWorker(int id, const std::vector<int>& skills);
+    void RemoveWorker(int id);
+    void AddSkill(int id, int work);
+    void RemoveSkill(int id, int work);
+    void AddWork(int work);
+    void RemoveWork(int work);
+
+    // id работников команды или всех работников, если покрытия нет
+    std::vector<int> GetTeam() const;
+
+private:
+    void SolveFrom(size_t size);
+    void SolveWith(int id);
+    size_t GetDenseIndex(int id) const;
+    std::vector<size_t> GetDenseTeam() const;
+    void SetTeam(const MinTeam& team);
+    bool IsTeamCovering() const;
+
+    std::set<int> m_works;
+    Workers m_workers;
+    std::unique_ptr<CoverageIndex> m_index;
+    // Нет, если покрытия нет
+    std::optional<std::vector<int>> m_team;
+};
@@ -0,0 +1,153 @@
+#include "Kernel.h"
+#include "Coverage.h"
+#include <algorithm>
+#include <set>
+
+
+bool RemoveEmptyWorkers(Kernel& kernel, const std::set<int>& required)
+{
+    bool isChanged = false;
+    for (auto worker = kernel.workers.begin(); worker != kernel.workers.end();)
+    {
+        auto& skills = worker->second;
+        std::sort(skills.begin(), skills.end());
+        skills.erase(std::unique(skills.begin(), skills.end()), skills.end());
+        std::erase_if(skills, [&](int work) { return required.count(work) == 0; });
+        if (skills.empty())
+        {
+            worker = kernel.workers.erase(worker);
+            kernel.report.emptyWorkers++;
+            isChanged = true;
+        }
+        else
+        {
+            worker++;
+        }
+    }
+    return isChanged;
+}
+
+// Навыки уже отсортированы RemoveEmptyWorkers. Из равных остаётся работник
+// с меньшим id, поглощённый убирается, даже если поглотивший потом уйдёт
+// как поглощённый кем-то ещё: отношение транзитивно.
+bool RemoveDominatedWorkers(Kernel& kernel)
+{
+    std::vector<std::pair<int, const std::vector<int>*>> workers;
+    for (const auto& [id, skills] : kernel.workers)
+    {
+        workers.emplace_back(id, &skills);
+    }
+    std::vector<bool> isRemoved(workers.size(), false);
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        const auto& first = *workers[i].second;
+        for (size_t j = i + 1; j < workers.size() && !isRemoved[i]; j++)
+        {
+            if (isRemoved[j])
+            {
+                continue;
+            }
+            const auto& second = *workers[j].second;
+            if (first == second)
+            {
+                isRemoved[j] = true;
+                kernel.report.duplicateWorkers++;
+            }
+            else if (first.size() < second.size()
+                     && std::includes(second.begin(), second.end(), first.begin(), first.end()))
+            {
+                isRemoved[i] = true;
+                kernel.report.dominatedWorkers++;
+            }
+            else if (second.size() < first.size()
+                     && std::includes(first.begin(), first.end(), second.begin(), second.end()))
+            {
+                isRemoved[j] = true;
+                kernel.report.dominatedWorkers++;
+            }
+        }
+    }
+
+    bool isChanged = false;
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        if (isRemoved[i])
+        {
+            kernel.workers.erase(workers[i].first);
+            isChanged = true;
+        }
+    }
+    return isChanged;
+}
+
+bool ForceUniqueProviders(Kernel& kernel, std::set<int>& required)
+{
+    std::map<int, int> providers;
+    std::map<int, int> providerCounts;
+    for (const auto& [id, skills] : kernel.workers)
+    {
+        for (int work : skills)
+        {
+            providers[work] = id;
+            providerCounts[work]++;
+        }
+    }
+    std::set<int> forced;
+    for (const auto& [work, count] : providerCounts)
+    {
+        if (count == 1)
+        {
+            forced.insert(providers[work]);
+        }
+    }
+
+    for (int id : forced)
+    {
+        for (int work : kernel.workers[id])
+        {
+            kernel.report.coveredWorks += required.erase(work);
+        }
+        kernel.workers.erase(id);
+        kernel.forcedWorkers.push_back(id);
+        kernel.report.forcedWorkers++;
+    }
+    return !forced.empty();
+}
+
+Kernel Reduce(const std::vector<int>& works, const Workers& workers)
+{
+    Kernel kernel{works, workers, {}, {}};
+    if (!CoverageIndex(works, workers).IsCoverable())
+    {
+        kernel.report.kernelWorkers = workers.size();
+        kernel.report.kernelWorks = works.size();
+        return kernel;
+    }
+
+    std::set<int> required(works.begin(), works.end());
+    bool isChanged = true;
+    while (isChanged)
+    {
+        kernel.report.rounds++;
+        isChanged = RemoveEmptyWorkers(kernel, required);
+        isChanged = RemoveDominatedWorkers(kernel) || isChanged;
+        isChanged = ForceUniqueProviders(kernel, required) || isChanged;
+    }
+
+    kernel.works.assign(required.begin(), required.end());
+    std::sort(kernel.forcedWorkers.begin(), kernel.forcedWorkers.end());
+    kernel.report.kernelWorkers = kernel.workers.size();
+    kernel.report.kernelWorks = kernel.works.size();
+    return kernel;
+}
+
+std::vector<int> ExpandTeam(const Kernel& kernel, const std::vector<int>& kernelTeam)
+{
+    std::vector<int> team = kernel.forcedWorkers;
+    if (!kernel.works.empty())
+    {
+        team.insert(team.end(), kernelTeam.begin(), kernelTeam.end());
+    }
+    std::sort(team.begin(), team.end());
+    return team;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "Roster.h"
+#include <cstddef>
+
+
+// Сколько убрало каждое правило сокращения
+struct KernelReport
+{
+    // Работники без требуемых навыков
+    size_t emptyWorkers = 0;
+    // Работники с тем же набором требуемых навыков, что у работника с меньшим id
+    size_t duplicateWorkers = 0;
+    // Работники, чьи требуемые навыки - строгое подмножество навыков другого
+    size_t dominatedWorkers = 0;
+    // Единственные владельцы какой-либо работы, они входят в любую команду
+    size_t forcedWorkers = 0;
+    // Работы, покрытые обязательными работниками
+    size_t coveredWorks = 0;
+    size_t rounds = 0;
+    size_t kernelWorkers = 0;
+    size_t kernelWorks = 0;
+};
+
+struct Kernel
+{
+    // Оставшиеся работы без повторов и работники, которые могут их покрыть
+    std::vector<int> works;
+    Workers workers;
+    // Обязательные работники по возрастанию id
+    std::vector<int> forcedWorkers;
+    KernelReport report;
+};
+
+// Применяет правила по кругу, пока хоть одно что-то убирает. Наименьшая
+// команда - forcedWorkers вместе с наименьшей командой ядра. Если покрыть
+// все работы нельзя, работы и работники возвращаются без изменений.
+Kernel Reduce(const std::vector<int>& works, const Workers& workers);
+// Объединяет обязательных работников с командой ядра
+std::vector<int> ExpandTeam(const Kernel& kernel, const std::vector<int>& kernelTeam);
@@ -0,0 +1,209 @@
+#include "MeetInTheMiddle.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+
+namespace
+{
+using Mask = std::uint32_t;
+
+const std::uint8_t NO_SUBSET = UINT8_MAX;
+
+// Обходит подмножества работников [worker, end) с их масками и размерами,
+// начиная с пустого. Подмножества, полученные добавлением работников после
+// последнего, обходятся, только если visit вернул true.
+template <typename Visit>
+void WalkSubsets(const std::vector<Mask>& masks, size_t end, Visit& visit, size_t worker, Mask mask, size_t size)
+{
+    if (!visit(mask, size))
+    {
+        return;
+    }
+    for (size_t next = worker; next < end; next++)
+    {
+        WalkSubsets(masks, end, visit, next + 1, mask | masks[next], size + 1);
+    }
+}
+
+template <typename Visit>
+void ForEachSubset(const std::vector<Mask>& masks, size_t first, size_t end, Visit visit)
+{
+    WalkSubsets(masks, end, visit, first, 0, 0);
+}
+
+// Для каждой маски работ - наименьший размер подмножества работников
+// [first, end), объединение масок которого ровно равно ей. Если работников не
+// больше, чем работ, обходятся их подмножества, иначе каждый работник один раз
+// проходит по таблице: шагов не больше min(2^работников, работников * 2^работ).
+template <typename IsStopped>
+std::vector<std::uint8_t> GetSmallestSubsets(const std::vector<Mask>& masks, size_t first, size_t end,
+                                             size_t workCount, IsStopped isStopped)
+{
+    std::vector<std::uint8_t> smallest(size_t(1) << workCount, NO_SUBSET);
+    if (end - first <= workCount)
+    {
+        ForEachSubset(masks, first, end, [&](Mask mask, size_t size) {
+            smallest[mask] = std::min<std::uint8_t>(smallest[mask], static_cast<std::uint8_t>(size));
+            return !isStopped();
+        });
+        return smallest;
+    }
+    smallest[0] = 0;
+    for (size_t worker = first; worker < end && !isStopped(); worker++)
+    {
+        // Объединение идемпотентно: маска, уже содержащая работника, от
+        // повторного добавления не меняется, поэтому таблица обновляется на месте
+        for (size_t mask = 0; mask < smallest.size(); mask++)
+        {
+            if (smallest[mask] != NO_SUBSET)
+            {
+                auto& next = smallest[mask | masks[worker]];
+                next = std::min<std::uint8_t>(next, static_cast<std::uint8_t>(smallest[mask] + 1));
+            }
+        }
+    }
+    return smallest;
+}
+
+// Подмножество работников [first, end) из smallest[mask] человек с
+// объединением mask. Без любого его участника остаётся подмножество на одного
+// меньше, и этот участник в нём не состоит, поэтому участники снимаются по
+// одному: ищется работник и маска без части его работ на единицу меньше.
+std::vector<size_t> GetSubset(const std::vector<Mask>& masks, size_t first, size_t end,
+                              const std::vector<std::uint8_t>& smallest, Mask mask)
+{
+    std::vector<size_t> subset;
+    while (smallest[mask] != 0)
+    {
+        bool isFound = false;
+        for (size_t worker = first; worker < end && !isFound; worker++)
+        {
+            Mask own = masks[worker];
+            if ((own & ~mask) != 0)
+            {
+                continue;
+            }
+            for (Mask part = own; !isFound; part = (part - 1) & own)
+            {
+                Mask rest = (mask & ~own) | part;
+                if (smallest[rest] + 1 == smallest[mask])
+                {
+                    subset.push_back(worker);
+                    mask = rest;
+                    isFound = true;
+                }
+                if (part == 0)
+                {
+                    break;
+                }
+            }
+        }
+    }
+    std::sort(subset.begin(), subset.end());
+    return subset;
+}
+}
+
+MinTeam FindMinTeamMeetInTheMiddle(const CoverageIndex& index, SharedBound* bound)
+{
+    if (!index.IsCoverable())
+    {
+        return std::nullopt;
+    }
+    // Сужение работ квадратично по их числу, поэтому работники проверяются до него
+    size_t workersNumber = index.GetWorkerCount();
+    auto works = workersNumber <= MEET_IN_THE_MIDDLE_MAX_WORKERS ? GetEssentialWorks(index) : std::vector<size_t>{};
+    if (works.size() > MEET_IN_THE_MIDDLE_MAX_WORKS || workersNumber > MEET_IN_THE_MIDDLE_MAX_WORKERS)
+    {
+        throw std::invalid_argument("Too many works or workers for meet in the middle");
+    }
+
+    std::vector<size_t> bits(index.GetWorkCount(), works.size());
+    for (size_t bit = 0; bit < works.size(); bit++)
+    {
+        bits[works[bit]] = bit;
+    }
+    std::vector<Mask> masks(workersNumber, 0);
+    for (size_t worker = 0; worker < workersNumber; worker++)
+    {
+        for (size_t work : index.GetSkills(worker))
+        {
+            if (bits[work] < works.size())
+            {
+                masks[worker] |= Mask(1) << bits[work];
+            }
+        }
+    }
+    Mask full = (Mask(1) << works.size()) - 1;
+    size_t half = workersNumber / 2;
+    auto isStopped = [bound] {
+        return bound != nullptr && bound->IsStopped();
+    };
+
+    // smallest[m] - наименьший размер подмножества первой половины с маской,
+    // содержащей m
+    auto smallest = GetSmallestSubsets(masks, 0, half, works.size(), isStopped);
+    for (size_t bit = 0; bit < works.size(); bit++)
+    {
+        if (isStopped())
+        {
+            return std::nullopt;
+        }
+        for (size_t mask = 0; mask < smallest.size(); mask++)
+        {
+            if ((mask >> bit & 1) == 0)
+            {
+                smallest[mask] = std::min(smallest[mask], smallest[mask | size_t(1) << bit]);
+            }
+        }
+    }
+
+    // Вторая половина тоже сводится к таблице наименьших подмножеств по маскам,
+    // и каждая достижимая маска дополняется по первой таблице
+    auto second = GetSmallestSubsets(masks, half, workersNumber, works.size(), isStopped);
+    size_t bestSize = workersNumber + 1;
+    Mask bestSecond = 0;
+    Mask bestNeed = 0;
+    for (size_t mask = 0; mask < second.size(); mask++)
+    {
+        Mask need = full & ~static_cast<Mask>(mask);
+        if (second[mask] != NO_SUBSET && smallest[need] != NO_SUBSET && second[mask] + smallest[need] < bestSize)
+        {
+            bestSize = second[mask] + smallest[need];
+            bestSecond = static_cast<Mask>(mask);
+            bestNeed = need;
+        }
+    }
+
+    // Таблица первой половины после SOS хранит размеры для надмножеств, поэтому
+    // строится заново, и среди надмножеств bestNeed берётся маска того же размера
+    auto first = GetSmallestSubsets(masks, 0, half, works.size(), isStopped);
+    if (isStopped())
+    {
+        return std::nullopt;
+    }
+    Mask firstMask = bestNeed;
+    Mask free = full & ~bestNeed;
+    for (Mask extra = free;; extra = (extra - 1) & free)
+    {
+        if (first[bestNeed | extra] == smallest[bestNeed])
+        {
+            firstMask = bestNeed | extra;
+            break;
+        }
+        if (extra == 0)
+        {
+            break;
+        }
+    }
+
+    auto team = GetSubset(masks, 0, half, first, firstMask);
+    auto secondTeam = GetSubset(masks, half, workersNumber, second, bestSecond);
+    team.insert(team.end(), secondTeam.begin(), secondTeam.end());
+    if (bound != nullptr)
+    {
+        bound->Offer(team);
+    }
+    return team;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "Coverage.h"
+#include "SharedBound.h"
+
+
+// Таблица наименьших размеров занимает 2^работ байт
+const size_t MEET_IN_THE_MIDDLE_MAX_WORKS = 26;
+const size_t MEET_IN_THE_MIDDLE_MAX_WORKERS = 60;
+
+// Наименьшая команда встречей посередине. Работы сужаются до
+// GetEssentialWorks, маски работников становятся 32-битными. Работники
+// делятся пополам. Для каждой маски работ первая половина даёт наименьший
+// размер своего подмножества с такой маской, затем преобразование по
+// надмножествам (SOS) даёт наименьший размер подмножества, покрывающего
+// маску. Вторая половина сводится к такой же таблице наименьших подмножеств
+// по точным маскам, и каждая её маска дополняется по первой таблице. Таблица
+// половины строится перебором подмножеств или проходами работников по маскам,
+// поэтому время не больше min(2^(n/2), n * 2^работ) + 2^работ * работ вместо
+// C(n, k) по всем k.
+//
+// Возвращает плотные номера по возрастанию, std::nullopt, если покрытия нет
+// или bound остановлен; найденная команда передаётся в bound.
+// std::invalid_argument, если после сужения больше MEET_IN_THE_MIDDLE_MAX_WORKS
+// работ или работников больше MEET_IN_THE_MIDDLE_MAX_WORKERS.
+MinTeam FindMinTeamMeetInTheMiddle(const CoverageIndex& index, SharedBound* bound = nullptr);
@@ -0,0 +1,186 @@
+#include "ParallelSearch.h"
+#include "BruteForce.h"
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <stdexcept>
+#include <thread>
+
+
+namespace
+{
+const std::uint64_t NOT_FOUND = UINT64_MAX;
+
+// Общее состояние потоков. Размер сменяется на барьере, когда все потоки
+// закончили предыдущий.
+class LevelSearch
+{
+public:
+    LevelSearch(const CoverageIndex& index, unsigned threadCount, std::uint64_t chunkSize)
+        : m_index(index),
+          m_chunkSize(std::max<std::uint64_t>(chunkSize, 1)),
+          m_levelCounts(index.GetWorkerCount() + 1, NOT_FOUND),
+          m_barrier(threadCount, LevelCompletion{this})
+    {
+        for (size_t k = 1; k < m_levelCounts.size(); k++)
+        {
+            try
+            {
+                m_levelCounts[k] = GetBinomial(index.GetWorkerCount(), k);
+            }
+            catch (const std::overflow_error&)
+            {
+                break;
+            }
+        }
+    }
+
+    void Run()
+    {
+        size_t workersNumber = m_index.GetWorkerCount();
+        size_t wordCount = m_index.GetWordCount();
+        std::vector<size_t> state;
+        std::vector<Word> prefixes((workersNumber + 1) * wordCount, 0);
+        while (!m_isDone)
+        {
+            size_t k = m_level;
+            std::uint64_t total = m_levelCounts[k];
+            while (true)
+            {
+                std::uint64_t start = m_nextChunk.fetch_add(1) * m_chunkSize;
+                if (start >= total || start >= m_bestRank.load(std::memory_order_relaxed))
+                {
+                    break;
+                }
+                SearchChunk(k, start, std::min(total, start + m_chunkSize), state, prefixes);
+            }
+            m_barrier.arrive_and_wait();
+        }
+    }
+
+    std::vector<size_t> GetTeam() const
+    {
+        if (m_isOverflowed)
+        {
+            throw std::overflow_error("Too many combinations");
+        }
+        if (m_bestRank == NOT_FOUND)
+        {
+            return {};
+        }
+        return UnrankCombination(m_index.GetWorkerCount(), m_level, m_bestRank);
+    }
+
+private:
+    struct LevelCompletion
+    {
+        LevelSearch* search;
+
+        void operator()() noexcept
+        {
+            search->m_nextChunk = 0;
+            if (search->m_bestRank != NOT_FOUND || search->m_level + 1 >= search->m_levelCounts.size())
+            {
+                search->m_isDone = true;
+                return;
+            }
+            search->m_level++;
+            if (search->m_levelCounts[search->m_level] == NOT_FOUND)
+            {
+                search->m_isOverflowed = true;
+                search->m_isDone = true;
+            }
+        }
+    };
+
+    // Сочетания с номерами [start, end) размера k, префиксы масок как в
+    // последовательном переборе
+    void SearchChunk(size_t k, std::uint64_t start, std::uint64_t end, std::vector<size_t>& state,
+                     std::vector<Word>& prefixes)
+    {
+        size_t wordCount = m_index.GetWordCount();
+        auto combination = UnrankCombination(m_index.GetWorkerCount(), k, start);
+        state.resize(k + 1);
+        for (size_t i = 1; i <= k; i++)
+        {
+            state[i] = combination[i - 1] + 1;
+        }
+        size_t changed = 1;
+        for (std::uint64_t rank = start; rank < end; rank++)
+        {
+            if (rank >= m_bestRank.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            for (size_t i = changed; i <= k; i++)
+            {
+                const Word* previous = prefixes.data() + (i - 1) * wordCount;
+                const Word* mask = m_index.GetMask(state[i] - 1);
+                Word* prefix = prefixes.data() + i * wordCount;
+                for (size_t word = 0; word < wordCount; word++)
+                {
+                    prefix[word] = previous[word] | mask[word];
+                }
+            }
+            if (m_index.IsCovering(prefixes.data() + k * wordCount))
+            {
+                std::uint64_t best = m_bestRank.load();
+                while (rank < best && !m_bestRank.compare_exchange_weak(best, rank))
+                {
+                }
+                return;
+            }
+            NextCombinations(m_index.GetWorkerCount(), state, changed);
+        }
+    }
+
+    const CoverageIndex& m_index;
+    std::uint64_t m_chunkSize;
+    // Число сочетаний каждого размера, NOT_FOUND - не помещается в 64 бита
+    std::vector<std::uint64_t> m_levelCounts;
+    std::barrier<LevelCompletion> m_barrier;
+    std::atomic<std::uint64_t> m_nextChunk = 0;
+    std::atomic<std::uint64_t> m_bestRank = NOT_FOUND;
+    size_t m_level = 1;
+    bool m_isDone = false;
+    bool m_isOverflowed = false;
+};
+}
+
+MinTeam FindMinTeamParallel(const CoverageIndex& index, unsigned threadCount, std::uint64_t chunkSize)
+{
+    if (!index.IsCoverable())
+    {
+        return std::nullopt;
+    }
+    if (index.GetWorkCount() == 0)
+    {
+        return std::vector<size_t>{};
+    }
+    // Потоки делят сочетания через префиксы плотных масок, для сжатых карт
+    // остаётся последовательный перебор
+    if (!index.HasMasks())
+    {
+        return FindMinTeam(index, EnumerationOrder::Lexicographic);
+    }
+    threadCount = std::max(threadCount, 1u);
+    LevelSearch search(index, threadCount, chunkSize);
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; i++)
+    {
+        threads.emplace_back([&search] { search.Run(); });
+    }
+    search.Run();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    return search.GetTeam();
+}
+
+std::vector<int> GetMinWorkersParallel(const std::vector<int>& works, const Workers& workers,
+                                       unsigned threadCount)
+{
+    CoverageIndex index(works, workers);
+    return GetWorkerIds(index, FindMinTeamParallel(index, threadCount));
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include "Coverage.h"
+
+
+// Сочетаний в одном задании потока
+const std::uint64_t PARALLEL_CHUNK_SIZE = 4096;
+
+// Лексикографический перебор, как FindMinTeam, в threadCount потоках. Сочетания
+// одного размера делятся на отрезки номеров, отрезок начинается с
+// UnrankCombination. Потоки берут отрезки по возрастанию номеров и прекращают
+// перебор, как только все сочетания с меньшими номерами, чем у найденной
+// команды, проверены, поэтому результат совпадает с последовательным.
+MinTeam FindMinTeamParallel(const CoverageIndex& index, unsigned threadCount,
+                            std::uint64_t chunkSize = PARALLEL_CHUNK_SIZE);
+// id работников по FindMinTeamParallel или всех работников, если покрытия нет
+std::vector<int> GetMinWorkersParallel(const std::vector<int>& works, const Workers& workers,
+                                       unsigned threadCount);
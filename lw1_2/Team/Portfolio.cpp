@@ -0,0 +1,202 @@
+#include "Portfolio.h"
+#include "Anytime.h"
+#include "BruteForce.h"
+#include "DancingLinks.h"
+#include "MeetInTheMiddle.h"
+#include "SharedBound.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+
+namespace
+{
+const std::pair<Strategy, const char*> STRATEGY_NAMES[] = {
+    {Strategy::BruteForce, "brute-force"},
+    {Strategy::DancingLinks, "dlx"},
+    {Strategy::MeetInTheMiddle, "meet-in-the-middle"},
+    {Strategy::Anytime, "anytime"},
+};
+
+// Перебор по возрастанию размера. Все команды меньше размера уже проверены,
+// поэтому, дойдя до размера рекорда, он доказывает, что рекорд наименьший.
+bool RunBruteForce(const CoverageIndex& index, SharedBound& bound, StrategyRun& run)
+{
+    if (index.GetWorkCount() == 0)
+    {
+        run.teamSize = 0;
+        bound.Offer({});
+        return true;
+    }
+    for (size_t size = 1; size <= index.GetWorkerCount() && size < bound.GetSize(); size++)
+    {
+        auto team = FindTeamOfSize(index, size, std::nullopt, &bound);
+        if (!team.empty())
+        {
+            run.teamSize = team.size();
+            bound.Offer(team);
+            return true;
+        }
+        // Без команды нельзя отличить прерванный перебор от завершённого
+        if (bound.IsStopped())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// true, если стратегия доказала, что команда в bound наименьшая. Работы
+// покрываемы, это проверяет RunPortfolio.
+bool RunStrategy(const CoverageIndex& index, SharedBound& bound, std::chrono::milliseconds anytimeLimit,
+                 StrategyRun& run)
+{
+    switch (run.strategy)
+    {
+    case Strategy::BruteForce:
+        return RunBruteForce(index, bound, run);
+    case Strategy::DancingLinks:
+    {
+        DancingLinks search(index);
+        auto team = search.FindMinTeam(&bound);
+        if (team)
+        {
+            run.teamSize = team->size();
+        }
+        // Остановка другой стратегией после конца поиска не отменяет доказательства
+        return team && search.IsComplete();
+    }
+    case Strategy::MeetInTheMiddle:
+        try
+        {
+            // std::nullopt - поиск остановлен
+            auto team = FindMinTeamMeetInTheMiddle(index, &bound);
+            if (team)
+            {
+                run.teamSize = team->size();
+            }
+            return team.has_value();
+        }
+        catch (const std::invalid_argument&)
+        {
+            run.outcome = StrategyOutcome::NotApplicable;
+            return false;
+        }
+    case Strategy::Anytime:
+    {
+        // Нижняя оценка верна и после остановки, рекорд её достиг - он наименьший
+        auto result = FindTeamAnytime(index, anytimeLimit, &bound);
+        if (result.team)
+        {
+            run.teamSize = result.team->size();
+        }
+        return result.team && result.lowerBound >= bound.GetSize();
+    }
+    }
+    return false;
+}
+}
+
+std::string GetStrategyName(Strategy strategy)
+{
+    for (const auto& [value, name] : STRATEGY_NAMES)
+    {
+        if (value == strategy)
+        {
+            return name;
+        }
+    }
+    return {};
+}
+
+Strategy GetStrategy(const std::string& name)
+{
+    for (const auto& [value, strategyName] : STRATEGY_NAMES)
+    {
+        if (name == strategyName)
+        {
+            return value;
+        }
+    }
+    throw std::invalid_argument("Unknown strategy: " + name);
+}
+
+PortfolioResult RunPortfolio(const CoverageIndex& index, const std::vector<Strategy>& strategies,
+                             unsigned threadCount, std::optional<std::chrono::milliseconds> timeLimit)
+{
+    if (strategies.empty())
+    {
+        throw std::invalid_argument("Empty strategy portfolio");
+    }
+    PortfolioResult result;
+    for (Strategy strategy : strategies)
+    {
+        result.report.runs.push_back({.strategy = strategy});
+    }
+    if (!index.IsCoverable())
+    {
+        return result;
+    }
+
+    SharedBound bound;
+    auto anytimeLimit = timeLimit.value_or(PORTFOLIO_ANYTIME_LIMIT);
+    threadCount = std::clamp<unsigned>(threadCount, 1, static_cast<unsigned>(strategies.size()));
+    std::atomic<size_t> next = 0;
+    std::mutex mutex;
+    std::condition_variable finished;
+    unsigned runningCount = threadCount;
+    auto runQueue = [&] {
+        for (size_t i = next++; i < strategies.size() && !bound.IsStopped(); i = next++)
+        {
+            auto& run = result.report.runs[i];
+            auto startTime = std::chrono::steady_clock::now();
+            bool isProved = RunStrategy(index, bound, anytimeLimit, run);
+            run.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()
+                                                                                - startTime);
+            if (run.outcome == StrategyOutcome::NotApplicable)
+            {
+                continue;
+            }
+            if (isProved)
+            {
+                run.outcome = bound.Stop() ? StrategyOutcome::Won : StrategyOutcome::Proved;
+                if (run.outcome == StrategyOutcome::Won)
+                {
+                    result.report.winner = run.strategy;
+                }
+            }
+            else
+            {
+                run.outcome = bound.IsStopped() ? StrategyOutcome::Cancelled : StrategyOutcome::Finished;
+            }
+        }
+        std::lock_guard lock(mutex);
+        runningCount--;
+        finished.notify_one();
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < threadCount; i++)
+    {
+        threads.emplace_back(runQueue);
+    }
+    if (timeLimit)
+    {
+        // Остановка по времени не делает победителем ни одну стратегию:
+        // доказавшие позже получают Proved
+        std::unique_lock lock(mutex);
+        if (!finished.wait_for(lock, *timeLimit, [&] { return runningCount == 0; }))
+        {
+            bound.Stop();
+        }
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    result.team = bound.GetTeam();
+    return result;
+}
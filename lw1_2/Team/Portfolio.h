@@ -0,0 +1,79 @@
+#pragma once
+#include "Coverage.h"
+#include <chrono>
+#include <optional>
+#include <string>
+
+
+// Сколько идёт локальный поиск в портфеле без общего ограничения времени
+const std::chrono::milliseconds PORTFOLIO_ANYTIME_LIMIT{1000};
+
+enum class Strategy
+{
+    BruteForce,
+    DancingLinks,
+    MeetInTheMiddle,
+    Anytime,
+};
+
+enum class StrategyOutcome
+{
+    // Первой доказала, что общая команда наименьшая
+    Won,
+    // Доказала это позже победителя
+    Proved,
+    // Закончила без доказательства: локальный поиск по своему времени
+    Finished,
+    // Экземпляр слишком велик для стратегии
+    NotApplicable,
+    Cancelled,
+    // Поиск закончился раньше, чем освободился поток
+    NotStarted,
+};
+
+struct StrategyRun
+{
+    Strategy strategy;
+    StrategyOutcome outcome = StrategyOutcome::NotStarted;
+    // Размер лучшей команды, найденной самой стратегией, нет - не нашла
+    std::optional<size_t> teamSize = std::nullopt;
+    std::chrono::microseconds elapsed{0};
+};
+
+struct PortfolioReport
+{
+    // Нет, если оптимальность никто не доказал, например до конца времени
+    std::optional<Strategy> winner;
+    // В порядке запуска
+    std::vector<StrategyRun> runs;
+};
+
+struct PortfolioResult
+{
+    // Нет и тогда, когда покрытие есть, но ни одна стратегия не нашла команду:
+    // все неприменимы или остановлены по времени раньше
+    MinTeam team;
+    PortfolioReport report;
+};
+
+// Имя стратегии в командной строке: brute-force, dlx, meet-in-the-middle, anytime
+std::string GetStrategyName(Strategy strategy);
+// std::invalid_argument, если имя неизвестно
+Strategy GetStrategy(const std::string& name);
+
+// Стратегии берутся по порядку из общей очереди threadCount потоками и
+// делят SharedBound: каждая найденная команда становится общим рекордом,
+// по которому отсекают ветви перебор по размерам и DancingLinks, а
+// локальный поиск сверяет с ним свою нижнюю оценку. Стратегия, первой
+// доказавшая, что рекорд наименьший, останавливает остальные, они
+// прерываются на ближайшей проверке.
+//
+// По истечении timeLimit стратегии останавливаются так же, и возвращается
+// лучшая найденная команда без победителя. Локальный поиск идёт не дольше
+// timeLimit, без него - PORTFOLIO_ANYTIME_LIMIT.
+//
+// Команда - одна из наименьших, но не обязательно лексикографически первая.
+// std::invalid_argument, если strategies пуст.
+PortfolioResult RunPortfolio(const CoverageIndex& index, const std::vector<Strategy>& strategies,
+                             unsigned threadCount,
+                             std::optional<std::chrono::milliseconds> timeLimit = std::nullopt);
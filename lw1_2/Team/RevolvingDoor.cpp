@@ -0,0 +1,81 @@
+#include "RevolvingDoor.h"
+
+
+RevolvingDoor::RevolvingDoor(size_t n, size_t t)
+    : m_t(t)
+    , m_c(t + 2)
+{
+    for (size_t j = 1; j <= t; j++)
+    {
+        m_c[j] = j - 1;
+    }
+    m_c[t + 1] = n;
+}
+
+const size_t* RevolvingDoor::GetCombination() const
+{
+    return m_c.data() + 1;
+}
+
+bool RevolvingDoor::Next(size_t& removed, size_t& added)
+{
+    if (m_t == 0)
+    {
+        return false;
+    }
+    size_t j = 2;
+    bool increase;
+    if (m_t % 2 == 1)
+    {
+        if (m_c[1] + 1 < m_c[2])
+        {
+            removed = m_c[1]++;
+            added = m_c[1];
+            return true;
+        }
+        increase = false;
+    }
+    else
+    {
+        if (m_c[1] > 0)
+        {
+            removed = m_c[1]--;
+            added = m_c[1];
+            return true;
+        }
+        increase = true;
+    }
+
+    while (j <= m_t)
+    {
+        if (!increase)
+        {
+            // c[j] = c[j - 1] + 1: пробуем уменьшить c[j]
+            if (m_c[j] >= j)
+            {
+                removed = m_c[j];
+                added = j - 2;
+                m_c[j] = m_c[j - 1];
+                m_c[j - 1] = j - 2;
+                return true;
+            }
+            j++;
+        }
+        // c[j - 1] = j - 2: пробуем увеличить c[j]
+        if (j > m_t)
+        {
+            break;
+        }
+        if (m_c[j] + 1 < m_c[j + 1])
+        {
+            removed = m_c[j - 1];
+            added = m_c[j] + 1;
+            m_c[j - 1] = m_c[j];
+            m_c[j]++;
+            return true;
+        }
+        j++;
+        increase = false;
+    }
+    return false;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+
+// Сочетания из n по t в порядке «вращающейся двери» (Knuth, TAOCP 7.2.1.3,
+// алгоритм R): соседние сочетания отличаются заменой одного элемента.
+class RevolvingDoor
+{
+public:
+    RevolvingDoor(size_t n, size_t t);
+
+    // t элементов текущего сочетания по возрастанию
+    const size_t* GetCombination() const;
+    // Переходит к следующему сочетанию и сообщает, какой элемент из него ушёл
+    // и какой пришёл. false, если сочетание было последним.
+    bool Next(size_t& removed, size_t& added);
+
+private:
+    size_t m_t;
+    // m_c[1..t] - сочетание, m_c[t + 1] = n
+    std::vector<size_t> m_c;
+};
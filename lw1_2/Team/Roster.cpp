@@ -0,0 +1,257 @@
+#include "Roster.h"
+#include <algorithm>
+#include <charconv>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+std::vector<int> GetWorks(std::istream& file)
+{
+    std::vector<int> works;
+
+    int number;
+    while (file >> number)
+    {
+        works.push_back(number);
+    }
+    return works;
+}
+
+Workers GetWorkers(std::istream& file)
+{
+    Workers workers;
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        std::istringstream iss(line);
+        int worker;
+        if (!(iss >> worker))
+        {
+            continue;
+        }
+        std::vector<int> works;
+        int number;
+        while (iss >> number)
+        {
+            works.push_back(number);
+        }
+        workers[worker] = works;
+    }
+    return workers;
+}
+
+std::vector<int> GetKeys(const Workers& map)
+{
+    std::vector<int> keys;
+
+    for (const auto& item : map)
+    {
+        keys.push_back(item.first);
+    }
+    return keys;
+}
+
+size_t Roster::GetWorkerCount() const
+{
+    return ids.size();
+}
+
+std::span<const int> Roster::GetSkills(size_t worker) const
+{
+    return {skills.data() + offsets[worker], skills.data() + offsets[worker + 1]};
+}
+
+Roster ToRoster(const Workers& workers)
+{
+    Roster roster;
+    for (const auto& [id, skills] : workers)
+    {
+        roster.ids.push_back(id);
+        roster.skills.insert(roster.skills.end(), skills.begin(), skills.end());
+        roster.offsets.push_back(roster.skills.size());
+    }
+    return roster;
+}
+
+Workers ToWorkers(const Roster& roster)
+{
+    Workers workers;
+    for (size_t worker = 0; worker < roster.GetWorkerCount(); worker++)
+    {
+        auto skills = roster.GetSkills(worker);
+        workers.emplace_hint(workers.end(), roster.ids[worker], std::vector<int>(skills.begin(), skills.end()));
+    }
+    return workers;
+}
+
+namespace
+{
+// Файл только для чтения, отображённый в память
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& fileName)
+    {
+        int descriptor = open(fileName.c_str(), O_RDONLY);
+        struct stat status{};
+        if (descriptor < 0 || fstat(descriptor, &status) != 0)
+        {
+            if (descriptor >= 0)
+            {
+                close(descriptor);
+            }
+            throw std::invalid_argument("Failed to open input file");
+        }
+        m_size = static_cast<size_t>(status.st_size);
+        if (m_size > 0)
+        {
+            void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (data == MAP_FAILED)
+            {
+                close(descriptor);
+                throw std::invalid_argument("Failed to open input file");
+            }
+            madvise(data, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char*>(data);
+        }
+        close(descriptor);
+    }
+
+    ~MappedFile()
+    {
+        if (m_data != nullptr)
+        {
+            munmap(const_cast<char*>(m_data), m_size);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* begin() const
+    {
+        return m_data;
+    }
+
+    const char* end() const
+    {
+        return m_data + m_size;
+    }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+bool IsBlank(char symbol)
+{
+    return symbol == ' ' || symbol == '\t' || symbol == '\r' || symbol == '\v' || symbol == '\f';
+}
+
+// Разбирает число с позиции position и сдвигает её за него
+int ParseNumber(const char*& position, const char* end, size_t line)
+{
+    int number;
+    auto [next, error] = std::from_chars(position, end, number);
+    if (error != std::errc() || (next != end && !IsBlank(*next) && *next != '\n'))
+    {
+        throw std::invalid_argument("Wrong number in line " + std::to_string(line));
+    }
+    position = next;
+    return number;
+}
+}
+
+std::vector<int> LoadWorks(const std::string& fileName)
+{
+    MappedFile file(fileName);
+    std::vector<int> works;
+    const char* position = file.begin();
+    size_t line = 1;
+    while (position != file.end())
+    {
+        if (*position == '\n')
+        {
+            line++;
+            position++;
+        }
+        else if (IsBlank(*position))
+        {
+            position++;
+        }
+        else
+        {
+            works.push_back(ParseNumber(position, file.end(), line));
+        }
+    }
+    return works;
+}
+
+// Строки разбираются в порядке файла. Если id не возрастают, работники
+// переставляются, из повторов остаётся последняя строка.
+Roster LoadRoster(const std::string& fileName)
+{
+    MappedFile file(fileName);
+    Roster roster;
+    bool isSorted = true;
+    const char* position = file.begin();
+    for (size_t line = 1; position != file.end(); line++)
+    {
+        const char* lineEnd = std::find(position, file.end(), '\n');
+        bool isFirst = true;
+        while (position != lineEnd)
+        {
+            if (IsBlank(*position))
+            {
+                position++;
+                continue;
+            }
+            int number = ParseNumber(position, lineEnd, line);
+            if (isFirst)
+            {
+                isSorted = isSorted && (roster.ids.empty() || roster.ids.back() < number);
+                roster.ids.push_back(number);
+                isFirst = false;
+            }
+            else
+            {
+                roster.skills.push_back(number);
+            }
+        }
+        if (!isFirst)
+        {
+            roster.offsets.push_back(roster.skills.size());
+        }
+        position = lineEnd == file.end() ? lineEnd : lineEnd + 1;
+    }
+    if (isSorted)
+    {
+        return roster;
+    }
+
+    std::vector<size_t> order(roster.ids.size());
+    for (size_t worker = 0; worker < order.size(); worker++)
+    {
+        order[worker] = worker;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t left, size_t right) { return roster.ids[left] < roster.ids[right]; });
+    Roster sorted;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        if (i + 1 < order.size() && roster.ids[order[i + 1]] == roster.ids[order[i]])
+        {
+            continue;
+        }
+        auto skills = roster.GetSkills(order[i]);
+        sorted.ids.push_back(roster.ids[order[i]]);
+        sorted.skills.insert(sorted.skills.end(), skills.begin(), skills.end());
+        sorted.offsets.push_back(sorted.skills.size());
+    }
+    return sorted;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <istream>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+
+using Workers = std::map<int, std::vector<int>>;
+
+std::vector<int> GetWorks(std::istream& file);
+Workers GetWorkers(std::istream& file);
+std::vector<int> GetKeys(const Workers& map);
+
+// Работники в сжатом виде: навыки работника worker (плотный номер) занимают
+// skills[offsets[worker]..offsets[worker + 1]). Работники идут по возрастанию id.
+struct Roster
+{
+    std::vector<int> ids;
+    std::vector<size_t> offsets{0};
+    std::vector<int> skills;
+
+    size_t GetWorkerCount() const;
+    std::span<const int> GetSkills(size_t worker) const;
+};
+
+Roster ToRoster(const Workers& workers);
+Workers ToWorkers(const Roster& roster);
+// Читают файл, отображённый в память, числа разбираются std::from_chars.
+// Формат тот же, что у GetWorks и GetWorkers: пустые строки пропускаются,
+// повторный id заменяет навыки. std::invalid_argument, если файл не открылся
+// или в нём встретилось не число.
+std::vector<int> LoadWorks(const std::string& fileName);
+Roster LoadRoster(const std::string& fileName);
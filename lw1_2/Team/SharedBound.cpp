@@ -0,0 +1,43 @@
+#include "SharedBound.h"
+
+
+bool SharedBound::Offer(const std::vector<size_t>& team)
+{
+    if (team.size() >= m_size.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+    std::lock_guard lock(m_mutex);
+    if (team.size() >= m_size)
+    {
+        return false;
+    }
+    m_team = team;
+    m_size = team.size();
+    return true;
+}
+
+size_t SharedBound::GetSize() const
+{
+    return m_size.load(std::memory_order_relaxed);
+}
+
+std::optional<std::vector<size_t>> SharedBound::GetTeam() const
+{
+    std::lock_guard lock(m_mutex);
+    if (m_size == SIZE_MAX)
+    {
+        return std::nullopt;
+    }
+    return m_team;
+}
+
+bool SharedBound::Stop()
+{
+    return !m_isStopped.exchange(true);
+}
+
+bool SharedBound::IsStopped() const
+{
+    return m_isStopped.load(std::memory_order_relaxed);
+}
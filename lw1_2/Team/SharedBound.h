@@ -0,0 +1,32 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+
+// Лучшая известная команда, общая для стратегий, работающих одновременно, и
+// флаг кооперативной отмены. Стратегии отсекают ветви, которые не дают
+// команды меньше GetSize(), и сверяются с IsStopped() между шагами поиска.
+class SharedBound
+{
+public:
+    // Запоминает team (плотные номера), если она меньше лучшей. true, если запомнена.
+    // Пустая команда - настоящая: она покрывает всё, когда работ нет.
+    bool Offer(const std::vector<size_t>& team);
+    // Размер лучшей команды, SIZE_MAX, пока её нет
+    size_t GetSize() const;
+    // std::nullopt, пока команды нет
+    std::optional<std::vector<size_t>> GetTeam() const;
+    // true, если остановка запрошена этим вызовом, а не раньше
+    bool Stop();
+    bool IsStopped() const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::atomic<size_t> m_size = SIZE_MAX;
+    std::vector<size_t> m_team;
+    std::atomic<bool> m_isStopped = false;
+};
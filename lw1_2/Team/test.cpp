@@ -0,0 +1,992 @@
+#include "Roster.h"
+#include "CompressedBitmap.h"
+#include "Coverage.h"
+#include "BruteForce.h"
+#include "DancingLinks.h"
+#include "Anytime.h"
+#include "ParallelSearch.h"
+#include "Kernel.h"
+#include "Incremental.h"
+#include "Counting.h"
+#include "MeetInTheMiddle.h"
+#include "Portfolio.h"
+#include "SharedBound.h"
+#include "RevolvingDoor.h"
+#include "catch2/catch_all.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+
+
+Workers GenerateWorkers(size_t workerCount, int workCount, int maxSkills, std::mt19937& generator)
+{
+    std::uniform_int_distribution<int> skillCount(0, maxSkills);
+    std::uniform_int_distribution<int> work(1, workCount);
+    Workers workers;
+    for (size_t id = 1; id <= workerCount; id++)
+    {
+        auto& skills = workers[static_cast<int>(id)];
+        for (int i = skillCount(generator); i > 0; i--)
+        {
+            skills.push_back(work(generator));
+        }
+    }
+    return workers;
+}
+
+std::vector<int> GenerateWorks(int workCount)
+{
+    std::vector<int> works(workCount);
+    for (int i = 0; i < workCount; i++)
+    {
+        works[i] = i + 1;
+    }
+    return works;
+}
+
+bool IsTeamEnough(const Workers& workers, const std::vector<int>& team, const std::vector<int>& works)
+{
+    std::set<int> covered;
+    for (int id : team)
+    {
+        covered.insert(workers.at(id).begin(), workers.at(id).end());
+    }
+    return std::all_of(works.begin(), works.end(), [&](int work) { return covered.count(work) != 0; });
+}
+
+// Плотные номера работников с id из team
+std::vector<size_t> ToDenseTeam(const CoverageIndex& index, const std::vector<int>& team)
+{
+    std::vector<size_t> dense;
+    for (size_t worker = 0; worker < index.GetWorkerCount(); worker++)
+    {
+        if (std::find(team.begin(), team.end(), index.GetWorkerId(worker)) != team.end())
+        {
+            dense.push_back(worker);
+        }
+    }
+    return dense;
+}
+
+// Сверяет team с лексикографическим перебором: покрытие есть у обоих или ни у
+// одного, размеры равны, номера по возрастанию и покрывают все работы
+void RequireMinimumTeam(const CoverageIndex& index, const MinTeam& team)
+{
+    auto expected = FindMinTeam(index, EnumerationOrder::Lexicographic);
+    REQUIRE(team.has_value() == expected.has_value());
+    if (team)
+    {
+        REQUIRE(team->size() == expected->size());
+        REQUIRE(std::is_sorted(team->begin(), team->end()));
+        REQUIRE(index.IsCovered(team->data(), team->size()));
+    }
+}
+
+
+TEST_CASE("Roster")
+{
+    std::istringstream worksFile("1 2 3\n4\n");
+    std::istringstream workersFile("1   2 7 1\n3\n\n2   4\n");
+    REQUIRE(GetWorks(worksFile) == std::vector<int>{1, 2, 3, 4});
+
+    auto workers = GetWorkers(workersFile);
+    REQUIRE(GetKeys(workers) == std::vector<int>{1, 2, 3});
+    REQUIRE(workers[1] == std::vector<int>{2, 7, 1});
+    REQUIRE(workers[3].empty());
+}
+
+TEST_CASE("Roster loader")
+{
+    auto path = std::filesystem::temp_directory_path() / "team_roster_test.txt";
+    auto write = [&](const std::string& text) {
+        std::ofstream file(path, std::ios::binary);
+        file << text;
+    };
+
+    std::string text = "7   2 7 1\r\n3\n\n \t\n2\t4 -1\n7 5\n1 9 9";
+    write(text);
+    std::istringstream stream(text);
+    auto expected = GetWorkers(stream);
+    auto roster = LoadRoster(path.string());
+    REQUIRE(roster.ids == std::vector<int>{1, 2, 3, 7});
+    REQUIRE(roster.offsets == std::vector<size_t>{0, 2, 4, 4, 5});
+    REQUIRE(ToWorkers(roster) == expected);
+    REQUIRE(ToWorkers(ToRoster(expected)) == expected);
+    REQUIRE(LoadWorks(path.string()) == std::vector<int>{7, 2, 7, 1, 3, 2, 4, -1, 7, 5, 1, 9, 9});
+
+    write("1 2\n3 x\n");
+    REQUIRE_THROWS_AS(LoadRoster(path.string()), std::invalid_argument);
+    write("");
+    REQUIRE(LoadRoster(path.string()).ids.empty());
+    REQUIRE(LoadWorks(path.string()).empty());
+    std::filesystem::remove(path);
+    REQUIRE_THROWS_AS(LoadRoster(path.string()), std::invalid_argument);
+}
+
+TEST_CASE("Coverage index")
+{
+    std::mt19937 generator(1);
+    for (int workCount : {5, 64, 65, 300})
+    {
+        auto works = GenerateWorks(workCount);
+        auto workers = GenerateWorkers(12, workCount + 3, workCount / 2 + 2, generator);
+        CoverageIndex index(works, workers);
+        REQUIRE(index.GetWorkCount() == static_cast<size_t>(workCount));
+
+        std::uniform_int_distribution<size_t> teamSize(0, 12);
+        std::uniform_int_distribution<size_t> worker(0, 11);
+        for (int attempt = 0; attempt < 200; attempt++)
+        {
+            std::vector<size_t> team(teamSize(generator));
+            std::vector<int> ids;
+            for (auto& member : team)
+            {
+                member = worker(generator);
+                ids.push_back(index.GetWorkerId(member));
+            }
+            REQUIRE(index.IsCovered(team.data(), team.size()) == IsTeamEnough(workers, ids, works));
+        }
+    }
+}
+
+TEST_CASE("Coverage index updates")
+{
+    std::mt19937 generator(3);
+    for (size_t maxMaskBytes : {DENSE_MASKS_MAX_BYTES, size_t(256), size_t(0)})
+    {
+        auto works = GenerateWorks(60);
+        auto workers = GenerateWorkers(8, 70, 40, generator);
+        CoverageIndex index(works, workers, maxMaskBytes);
+
+        std::uniform_int_distribution<int> change(0, 5);
+        std::uniform_int_distribution<int> work(1, 70);
+        std::uniform_int_distribution<int> id(1, 14);
+        for (int step = 0; step < 300; step++)
+        {
+            int workerId = id(generator);
+            int skill = work(generator);
+            auto worker = workers.find(workerId);
+            size_t dense = static_cast<size_t>(std::distance(workers.begin(), workers.lower_bound(workerId)));
+            switch (change(generator))
+            {
+            case 0:
+                if (worker == workers.end())
+                {
+                    workers[workerId] = {skill, work(generator), work(generator)};
+                    index.InsertWorker(dense, workerId, workers[workerId]);
+                }
+                break;
+            case 1:
+                if (worker != workers.end())
+                {
+                    workers.erase(worker);
+                    index.EraseWorker(dense);
+                }
+                break;
+            case 2:
+                if (worker != workers.end())
+                {
+                    worker->second.push_back(skill);
+                    index.AddSkill(dense, skill);
+                }
+                break;
+            case 3:
+                if (worker != workers.end())
+                {
+                    std::erase(worker->second, skill);
+                    index.RemoveSkill(dense, skill);
+                }
+                break;
+            case 4:
+                if (std::find(works.begin(), works.end(), skill) == works.end())
+                {
+                    works.push_back(skill);
+                    std::vector<size_t> owners;
+                    for (const auto& [ownerId, skills] : workers)
+                    {
+                        if (std::find(skills.begin(), skills.end(), skill) != skills.end())
+                        {
+                            owners.push_back(ToDenseTeam(index, {ownerId}).front());
+                        }
+                    }
+                    index.AddWork(skill, owners);
+                }
+                break;
+            default:
+                std::erase(works, skill);
+                index.RemoveWork(skill);
+                break;
+            }
+
+            CoverageIndex expected(works, workers, maxMaskBytes);
+            REQUIRE(index.GetWorkerCount() == expected.GetWorkerCount());
+            REQUIRE(index.GetWorkCount() == expected.GetWorkCount());
+            REQUIRE(index.GetWordCount() == expected.GetWordCount());
+            REQUIRE(index.HasMasks() == expected.HasMasks());
+            REQUIRE(index.GetSkillCount() == expected.GetSkillCount());
+            for (size_t member = 0; member < index.GetWorkerCount(); member++)
+            {
+                REQUIRE(index.GetWorkerId(member) == expected.GetWorkerId(member));
+                REQUIRE(index.GetSkills(member).size() == expected.GetSkills(member).size());
+            }
+            REQUIRE(FindMinTeam(index, EnumerationOrder::Lexicographic)
+                    == FindMinTeam(expected, EnumerationOrder::Lexicographic));
+            for (int attempt = 0; attempt < 10 && index.GetWorkerCount() > 0; attempt++)
+            {
+                std::uniform_int_distribution<size_t> member(0, index.GetWorkerCount() - 1);
+                std::vector<size_t> team(1 + attempt % 6);
+                for (auto& teamMember : team)
+                {
+                    teamMember = member(generator);
+                }
+                REQUIRE(index.IsCovered(team.data(), team.size()) == expected.IsCovered(team.data(), team.size()));
+            }
+        }
+    }
+}
+
+TEST_CASE("Revolving door")
+{
+    for (size_t n = 1; n <= 9; n++)
+    {
+        for (size_t t = 1; t <= n; t++)
+        {
+            RevolvingDoor combinations(n, t);
+            std::vector<size_t> current(combinations.GetCombination(), combinations.GetCombination() + t);
+            std::set<std::vector<size_t>> visited = {current};
+            size_t removed;
+            size_t added;
+            while (combinations.Next(removed, added))
+            {
+                std::vector<size_t> next(combinations.GetCombination(), combinations.GetCombination() + t);
+                auto expected = current;
+                std::erase(expected, removed);
+                expected.push_back(added);
+                std::sort(expected.begin(), expected.end());
+                REQUIRE(next == expected);
+                REQUIRE(next.back() < n);
+                REQUIRE(visited.insert(next).second);
+                current = next;
+            }
+
+            size_t count = 1;
+            for (size_t i = 0; i < t; i++)
+            {
+                count = count * (n - i) / (i + 1);
+            }
+            REQUIRE(visited.size() == count);
+        }
+    }
+}
+
+TEST_CASE("Brute force")
+{
+    SECTION("Both enumeration orders find lexicographically first minimum team")
+    {
+        std::mt19937 generator(5);
+        for (int attempt = 0; attempt < 30; attempt++)
+        {
+            auto works = GenerateWorks(10);
+            auto workers = GenerateWorkers(9, 10, 4, generator);
+            CoverageIndex index(works, workers);
+
+            MinTeam expected;
+            for (size_t size = 1; size <= 9 && !expected; size++)
+            {
+                std::vector<bool> chosen(9, false);
+                std::fill(chosen.begin(), chosen.begin() + size, true);
+                do
+                {
+                    std::vector<size_t> team;
+                    for (size_t worker = 0; worker < 9; worker++)
+                    {
+                        if (chosen[worker])
+                        {
+                            team.push_back(worker);
+                        }
+                    }
+                    if (index.IsCovered(team.data(), team.size()))
+                    {
+                        expected = team;
+                        break;
+                    }
+                } while (std::prev_permutation(chosen.begin(), chosen.end()));
+            }
+            REQUIRE(FindMinTeam(index, EnumerationOrder::Lexicographic) == expected);
+            REQUIRE(FindMinTeam(index, EnumerationOrder::RevolvingDoor) == expected);
+        }
+    }
+
+    SECTION("Example roster")
+    {
+        Workers workers = {
+            {1, {2, 7, 1, 9}}, {2, {12, 7, 4}}, {3, {}}, {4, {6, 11, 3, 8, 9}},
+            {5, {12, 10, 8, 6, 4, 2}}, {6, {11, 9, 7, 5, 3, 1}}, {7, {8, 2, 5}}, {8, {}},
+            {9, {9, 4, 2}}, {10, {4, 10, 11}}, {11, {6, 10, 4, 3, 2, 1}}, {12, {7, 3, 9, 12, 5, 8, 2, 6}}
+        };
+        REQUIRE(GetMinWorkers(GenerateWorks(12), workers) == std::vector<int>{5, 6});
+    }
+
+    SECTION("Uncoverable works")
+    {
+        Workers workers = {{1, {1}}, {2, {2}}};
+        REQUIRE(GetMinWorkers({1, 2, 3}, workers) == std::vector<int>{1, 2});
+    }
+
+    SECTION("Every worker is needed")
+    {
+        Workers workers = {{1, {1}}, {2, {2}}, {3, {3}}};
+        REQUIRE(GetMinWorkers({1, 2, 3}, workers) == std::vector<int>{1, 2, 3});
+    }
+}
+
+TEST_CASE("Dancing links")
+{
+    SECTION("Finds a minimum team")
+    {
+        std::mt19937 generator(9);
+        for (int attempt = 0; attempt < 60; attempt++)
+        {
+            int workCount = attempt % 2 == 0 ? 12 : 70;
+            auto works = GenerateWorks(workCount);
+            auto workers = GenerateWorkers(14, workCount, workCount / 3, generator);
+            CoverageIndex index(works, workers);
+            DancingLinks search(index);
+            RequireMinimumTeam(index, search.FindMinTeam());
+        }
+    }
+
+    SECTION("Example roster")
+    {
+        Workers workers = {
+            {1, {2, 7, 1, 9}}, {2, {12, 7, 4}}, {3, {}}, {4, {6, 11, 3, 8, 9}},
+            {5, {12, 10, 8, 6, 4, 2}}, {6, {11, 9, 7, 5, 3, 1}}, {7, {8, 2, 5}}, {8, {}},
+            {9, {9, 4, 2}}, {10, {4, 10, 11}}, {11, {6, 10, 4, 3, 2, 1}}, {12, {7, 3, 9, 12, 5, 8, 2, 6}}
+        };
+        auto team = GetMinWorkersDancingLinks(GenerateWorks(12), workers);
+        REQUIRE(team.size() == 2);
+        REQUIRE(IsTeamEnough(workers, team, GenerateWorks(12)));
+    }
+
+    SECTION("Uncoverable works")
+    {
+        Workers workers = {{1, {1}}, {2, {2}}};
+        REQUIRE(GetMinWorkersDancingLinks({1, 2, 3}, workers) == std::vector<int>{1, 2});
+    }
+
+    SECTION("Reports whether the search completed")
+    {
+        Workers workers = {{1, {1, 2}}, {2, {2, 3}}, {3, {3, 4}}, {4, {1, 4}}};
+        CoverageIndex index(GenerateWorks(4), workers);
+        DancingLinks search(index);
+        SharedBound bound;
+        search.FindMinTeam(&bound);
+        REQUIRE(search.IsComplete());
+        bound.Stop();
+        search.FindMinTeam(&bound);
+        REQUIRE(!search.IsComplete());
+        search.FindMinTeam();
+        REQUIRE(search.IsComplete());
+    }
+}
+
+TEST_CASE("Anytime search")
+{
+    SECTION("Bounds the optimum from both sides")
+    {
+        std::mt19937 generator(13);
+        for (int attempt = 0; attempt < 40; attempt++)
+        {
+            auto works = GenerateWorks(30);
+            auto workers = GenerateWorkers(16, 30, 8, generator);
+            CoverageIndex index(works, workers);
+
+            DancingLinks search(index);
+            auto optimum = search.FindMinTeam();
+            auto greedy = FindGreedyTeam(index);
+            auto result = FindTeamAnytime(index, std::chrono::milliseconds(5));
+            REQUIRE(result.team.has_value() == optimum.has_value());
+            if (!optimum)
+            {
+                continue;
+            }
+            REQUIRE(result.team->size() >= optimum->size());
+            REQUIRE(index.IsCovered(greedy.data(), greedy.size()));
+            REQUIRE(index.IsCovered(result.team->data(), result.team->size()));
+            REQUIRE(result.team->size() <= greedy.size());
+            REQUIRE(result.lowerBound <= optimum->size());
+        }
+    }
+
+    SECTION("Large rosters")
+    {
+        // Здесь работы обычно покрыты несколькими членами команды, и до
+        // замены нескольких работников одним доходит
+        std::mt19937 generator(17);
+        auto works = GenerateWorks(300);
+        auto workers = GenerateWorkers(400, 300, 12, generator);
+        CoverageIndex index(works, workers);
+        REQUIRE(index.IsCoverable());
+        auto greedy = FindGreedyTeam(index);
+        auto result = FindTeamAnytime(index, std::chrono::milliseconds(200));
+        REQUIRE(index.IsCovered(result.team->data(), result.team->size()));
+        REQUIRE(result.team->size() <= greedy.size());
+        REQUIRE(result.lowerBound <= result.team->size());
+    }
+
+    SECTION("Stops once the gap is closed")
+    {
+        Workers workers = {{1, {1, 2}}, {2, {2, 3}}, {3, {3, 4}}, {4, {5}}, {5, {1, 2, 3}}};
+        auto start = std::chrono::steady_clock::now();
+        auto result = GetMinWorkersAnytime({1, 2, 3, 4, 5}, workers, std::chrono::hours(1));
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+        REQUIRE(result.lowerBound == size_t(3));
+        REQUIRE(result.workers.size() == 3);
+        REQUIRE(IsTeamEnough(workers, result.workers, {1, 2, 3, 4, 5}));
+    }
+
+    SECTION("Uncoverable works")
+    {
+        Workers workers = {{1, {1}}, {2, {2}}};
+        REQUIRE(GetMinWorkersAnytime({1, 2, 3}, workers, std::chrono::milliseconds(1)).workers
+                == std::vector<int>{1, 2});
+    }
+}
+
+TEST_CASE("Empty and uncoverable works")
+{
+    // Без работ наименьшая команда пуста, а без покрытия команды нет вовсе
+    Workers workers = {{1, {1}}, {2, {2}}, {3, {1, 2}}};
+    const std::vector<Strategy> all = {Strategy::DancingLinks, Strategy::BruteForce, Strategy::MeetInTheMiddle,
+                                       Strategy::Anytime};
+    for (const auto& [works, expected] : {std::pair{std::vector<int>{}, MinTeam(std::vector<size_t>{})},
+                                          std::pair{std::vector<int>{1, 2, 3}, MinTeam()}})
+    {
+        CoverageIndex index(works, workers);
+        DancingLinks search(index);
+        REQUIRE(FindMinTeam(index, EnumerationOrder::Lexicographic) == expected);
+        REQUIRE(FindMinTeam(index, EnumerationOrder::RevolvingDoor) == expected);
+        REQUIRE(FindMinTeamParallel(index, 2) == expected);
+        REQUIRE(search.FindMinTeam() == expected);
+        REQUIRE(FindMinTeamMeetInTheMiddle(index) == expected);
+        REQUIRE(FindTeamAnytime(index, std::chrono::milliseconds(1)).team == expected);
+        REQUIRE(RunPortfolio(index, all, 2).team == expected);
+
+        auto count = CountMinTeams(index);
+        REQUIRE(count.size == 0);
+        REQUIRE(count.count == (expected ? 1 : 0));
+    }
+
+    REQUIRE(GetMinWorkers({}, workers).empty());
+    REQUIRE(GetMinWorkersDancingLinks({}, workers).empty());
+    REQUIRE(GetMinWorkersParallel({}, workers, 2).empty());
+    REQUIRE(GetMinWorkersAnytime({}, workers, std::chrono::milliseconds(1)).lowerBound == size_t(0));
+    REQUIRE(!GetMinWorkersAnytime({1, 2, 3}, workers, std::chrono::milliseconds(1)).lowerBound);
+
+    TeamEngine engine({1}, workers);
+    REQUIRE(engine.GetTeam() == std::vector<int>{1});
+    engine.RemoveWork(1);
+    REQUIRE(engine.GetTeam().empty());
+    engine.AddWork(3);
+    REQUIRE(engine.GetTeam() == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("Combination ranks")
+{
+    for (size_t n = 1; n <= 8; n++)
+    {
+        for (size_t k = 1; k <= n; k++)
+        {
+            std::vector<size_t> state(k + 1);
+            for (size_t i = 1; i <= k; i++)
+            {
+                state[i] = i;
+            }
+            std::uint64_t rank = 0;
+            size_t changed;
+            do
+            {
+                std::vector<size_t> combination(state.begin() + 1, state.end());
+                for (auto& element : combination)
+                {
+                    element--;
+                }
+                REQUIRE(RankCombination(n, combination) == rank);
+                REQUIRE(UnrankCombination(n, k, rank) == combination);
+                rank++;
+            } while (NextCombinations(n, state, changed));
+            REQUIRE(rank == GetBinomial(n, k));
+        }
+    }
+    REQUIRE(GetBinomial(67, 33) == 14226520737620288370ull);
+    REQUIRE_THROWS_AS(GetBinomial(68, 34), std::overflow_error);
+    REQUIRE(UnrankCombination(60, 3, GetBinomial(60, 3) - 1) == std::vector<size_t>{57, 58, 59});
+}
+
+TEST_CASE("Parallel search")
+{
+    std::mt19937 generator(17);
+    for (int attempt = 0; attempt < 30; attempt++)
+    {
+        auto works = GenerateWorks(40);
+        auto workers = GenerateWorkers(12, 40, 10, generator);
+        CoverageIndex index(works, workers);
+
+        auto expected = FindMinTeam(index, EnumerationOrder::Lexicographic);
+        for (unsigned threadCount : {1u, 3u, 4u})
+        {
+            for (std::uint64_t chunkSize : {1ull, 7ull, 4096ull})
+            {
+                REQUIRE(FindMinTeamParallel(index, threadCount, chunkSize) == expected);
+            }
+        }
+    }
+
+    Workers workers = {{1, {1}}, {2, {2}}};
+    REQUIRE(GetMinWorkersParallel({1, 2, 3}, workers, 2) == std::vector<int>{1, 2});
+}
+
+TEST_CASE("Kernel")
+{
+    SECTION("Keeps the minimum team size")
+    {
+        std::mt19937 generator(21);
+        for (int attempt = 0; attempt < 60; attempt++)
+        {
+            auto works = GenerateWorks(20);
+            auto workers = GenerateWorkers(14, 22, 6, generator);
+            CoverageIndex index(works, workers);
+            if (!index.IsCoverable())
+            {
+                continue;
+            }
+
+            auto kernel = Reduce(works, workers);
+            REQUIRE(kernel.workers.size() + kernel.forcedWorkers.size() <= workers.size());
+            std::vector<int> kernelTeam;
+            if (!kernel.works.empty())
+            {
+                kernelTeam = GetMinWorkers(kernel.works, kernel.workers);
+            }
+            auto team = ExpandTeam(kernel, kernelTeam);
+            auto denseTeam = ToDenseTeam(index, team);
+            REQUIRE(denseTeam.size() == team.size());
+            RequireMinimumTeam(index, denseTeam);
+        }
+    }
+
+    SECTION("Report")
+    {
+        Workers workers = {{1, {1, 2}}, {2, {2, 3}}, {3, {3, 9}}, {4, {4}}, {5, {}}, {6, {3, 2}}};
+        auto kernel = Reduce({1, 2, 3, 4}, workers);
+        REQUIRE(kernel.report.emptyWorkers == 1);
+        REQUIRE(kernel.report.duplicateWorkers == 1);
+        REQUIRE(kernel.report.dominatedWorkers == 1);
+        REQUIRE(kernel.report.forcedWorkers == 3);
+        REQUIRE(kernel.report.coveredWorks == 4);
+        REQUIRE(kernel.works.empty());
+        REQUIRE(kernel.workers.empty());
+        REQUIRE(ExpandTeam(kernel, {}) == std::vector<int>{1, 2, 4});
+    }
+
+    SECTION("Uncoverable works are left as is")
+    {
+        Workers workers = {{1, {1}}, {2, {}}};
+        auto kernel = Reduce({1, 2}, workers);
+        REQUIRE(kernel.workers == workers);
+        REQUIRE(kernel.forcedWorkers.empty());
+    }
+}
+
+TEST_CASE("Team engine")
+{
+    SECTION("Matches a full recomputation after every change")
+    {
+        std::mt19937 generator(23);
+        for (int attempt = 0; attempt < 5; attempt++)
+        {
+            auto works = GenerateWorks(12);
+            auto workers = GenerateWorkers(8, 14, 5, generator);
+            TeamEngine engine(works, workers);
+            REQUIRE(engine.GetTeam() == GetMinWorkers(works, workers));
+
+            std::uniform_int_distribution<int> change(0, 5);
+            std::uniform_int_distribution<int> work(1, 14);
+            std::uniform_int_distribution<int> id(1, 12);
+            for (int step = 0; step < 60; step++)
+            {
+                int workerId = id(generator);
+                int skill = work(generator);
+                bool isKnown = workers.count(workerId) != 0;
+                switch (change(generator))
+                {
+                case 0:
+                    if (!isKnown)
+                    {
+                        workers[workerId] = {skill, work(generator)};
+                        engine.AddWorker(workerId, workers[workerId]);
+                    }
+                    break;
+                case 1:
+                    if (isKnown && workers.size() > 1)
+                    {
+                        workers.erase(workerId);
+                        engine.RemoveWorker(workerId);
+                    }
+                    break;
+                case 2:
+                    if (isKnown)
+                    {
+                        workers[workerId].push_back(skill);
+                        engine.AddSkill(workerId, skill);
+                    }
+                    break;
+                case 3:
+                    if (isKnown)
+                    {
+                        std::erase(workers[workerId], skill);
+                        engine.RemoveSkill(workerId, skill);
+                    }
+                    break;
+                case 4:
+                    if (std::find(works.begin(), works.end(), skill) == works.end())
+                    {
+                        works.push_back(skill);
+                        engine.AddWork(skill);
+                    }
+                    break;
+                default:
+                    if (works.size() > 1)
+                    {
+                        std::erase(works, skill);
+                        engine.RemoveWork(skill);
+                    }
+                    break;
+                }
+                REQUIRE(engine.GetTeam() == GetMinWorkers(works, workers));
+            }
+        }
+    }
+
+    SECTION("Rejects unknown and repeated workers")
+    {
+        TeamEngine engine({1}, {{1, {1}}});
+        REQUIRE_THROWS_AS(engine.AddWorker(1, {1}), std::invalid_argument);
+        REQUIRE_THROWS_AS(engine.RemoveWorker(2), std::invalid_argument);
+        REQUIRE_THROWS_AS(engine.AddSkill(2, 1), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Counting minimum teams")
+{
+    std::mt19937 generator(29);
+    for (int attempt = 0; attempt < 40; attempt++)
+    {
+        int workCount = attempt % 2 == 0 ? 12 : 70;
+        auto works = GenerateWorks(workCount);
+        auto workers = GenerateWorkers(attempt % 4 < 2 ? 10 : 30, workCount, workCount / 2, generator);
+        CoverageIndex index(works, workers);
+
+        DancingLinks search(index);
+        std::set<std::vector<size_t>> teams;
+        size_t listedCount = 0;
+        size_t size = search.ForEachMinTeam([&](const std::vector<size_t>& team) {
+            REQUIRE(index.IsCovered(team.data(), team.size()));
+            teams.insert(team);
+            listedCount++;
+        });
+        auto expected = FindMinTeam(index, EnumerationOrder::Lexicographic);
+        REQUIRE(size == (expected ? expected->size() : 0));
+        REQUIRE(teams.size() == listedCount);
+        auto count = CountMinTeams(index);
+        REQUIRE(count.size == size);
+        REQUIRE(count.count == listedCount);
+        if (size == 0 || workCount > 12)
+        {
+            continue;
+        }
+        REQUIRE(CountTeams(index, size) == listedCount);
+        REQUIRE(CountTeams(index, size - 1) == 0);
+
+        if (index.GetWorkerCount() <= 10)
+        {
+            // Перебором по всем командам размера на один больше
+            std::vector<size_t> state(size + 2);
+            for (size_t i = 1; i <= size + 1; i++)
+            {
+                state[i] = i;
+            }
+            uint64_t expected = 0;
+            size_t changed;
+            do
+            {
+                std::vector<size_t> team(state.begin() + 1, state.end());
+                for (auto& worker : team)
+                {
+                    worker--;
+                }
+                expected += index.IsCovered(team.data(), team.size());
+            } while (size + 1 <= index.GetWorkerCount() && NextCombinations(index.GetWorkerCount(), state, changed));
+            if (size + 1 <= index.GetWorkerCount())
+            {
+                REQUIRE(CountTeams(index, size + 1) == expected);
+            }
+        }
+    }
+
+    Workers workers = {{1, {1}}, {2, {1}}, {3, {2}}, {4, {2}}, {5, {1, 2}}};
+    CoverageIndex index({1, 2}, workers);
+    REQUIRE(CountTeams(index, 1) == 1);
+    REQUIRE(CountTeams(index, 2) == 8);
+    REQUIRE(CountTeams(CoverageIndex({1, 3}, workers), 2) == 0);
+}
+
+TEST_CASE("Meet in the middle")
+{
+    std::mt19937 generator(31);
+    for (int attempt = 0; attempt < 60; attempt++)
+    {
+        int workCount = attempt % 2 == 0 ? 10 : 20;
+        auto works = GenerateWorks(workCount);
+        auto workers = GenerateWorkers(static_cast<size_t>(1 + attempt % 17), workCount, workCount / 3, generator);
+        CoverageIndex index(works, workers);
+        RequireMinimumTeam(index, FindMinTeamMeetInTheMiddle(index));
+    }
+
+    // Половины больше числа работ обходятся проходами по таблице масок, и
+    // 60 работников не требуют 2^30 подмножеств
+    for (int attempt = 0; attempt < 20; attempt++)
+    {
+        int workCount = attempt % 2 == 0 ? 6 : 18;
+        auto works = GenerateWorks(workCount);
+        auto workers = GenerateWorkers(static_cast<size_t>(20 + attempt * 2), workCount, 4, generator);
+        CoverageIndex index(works, workers);
+        RequireMinimumTeam(index, FindMinTeamMeetInTheMiddle(index));
+    }
+
+    Workers workers;
+    for (int id = 1; id <= 30; id++)
+    {
+        workers[id] = {id};
+    }
+    REQUIRE_THROWS_AS(FindMinTeamMeetInTheMiddle(CoverageIndex(GenerateWorks(30), workers)), std::invalid_argument);
+}
+
+// Блоки разной плотности, чтобы встретились все виды контейнеров
+std::set<std::uint32_t> GenerateValues(std::mt19937& generator)
+{
+    std::set<std::uint32_t> values;
+    for (std::uint32_t chunk = 0; chunk < 5; chunk++)
+    {
+        std::uint32_t base = chunk << 16;
+        switch (generator() % 4)
+        {
+        case 0:
+            for (int i = 0; i < 50; i++)
+            {
+                values.insert(base + generator() % 65536);
+            }
+            break;
+        case 1:
+            for (int i = 0; i < 10000; i++)
+            {
+                values.insert(base + generator() % 65536);
+            }
+            break;
+        case 2:
+            for (int run = 0; run < 5; run++)
+            {
+                std::uint32_t start = generator() % 60000;
+                for (std::uint32_t value = start; value < start + generator() % 5000; value++)
+                {
+                    values.insert(base + value);
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return values;
+}
+
+CompressedBitmap ToBitmap(const std::set<std::uint32_t>& values)
+{
+    std::vector<std::uint32_t> sorted(values.begin(), values.end());
+    return CompressedBitmap::FromSorted(sorted);
+}
+
+TEST_CASE("Compressed bitmap")
+{
+    std::mt19937 generator(37);
+    for (int attempt = 0; attempt < 40; attempt++)
+    {
+        auto first = GenerateValues(generator);
+        auto second = GenerateValues(generator);
+        auto bitmap = ToBitmap(first);
+        REQUIRE(bitmap.GetCardinality() == first.size());
+        for (int i = 0; i < 1000; i++)
+        {
+            std::uint32_t value = generator() % (6 << 16);
+            REQUIRE(bitmap.Contains(value) == first.contains(value));
+        }
+
+        auto united = first;
+        united.insert(second.begin(), second.end());
+        bitmap.UnionWith(ToBitmap(second));
+        REQUIRE(bitmap.GetCardinality() == united.size());
+        REQUIRE(bitmap.Contains(ToBitmap(first)));
+        REQUIRE(bitmap.Contains(ToBitmap(second)));
+        REQUIRE(ToBitmap(first).Contains(bitmap) == (united.size() == first.size()));
+        REQUIRE(std::all_of(united.begin(), united.end(), [&](std::uint32_t value) {
+            return bitmap.Contains(value);
+        }));
+
+        std::uint32_t begin = generator() % (5 << 16);
+        std::uint32_t end = begin + generator() % 70000;
+        bool hasRange = true;
+        for (std::uint32_t value = begin; value < end && hasRange; value++)
+        {
+            hasRange = united.contains(value);
+        }
+        REQUIRE(bitmap.Contains(CompressedBitmap::FromRange(begin, end)) == hasRange);
+    }
+
+    auto full = CompressedBitmap::FromRange(0, 300000);
+    REQUIRE(full.GetCardinality() == 300000);
+    REQUIRE(full.GetSizeInBytes() < 1024);
+    REQUIRE(full.Contains(ToBitmap({0, 65535, 65536, 299999})));
+    REQUIRE(!full.Contains(300000));
+}
+
+TEST_CASE("Compressed coverage index")
+{
+    std::mt19937 generator(41);
+    for (int attempt = 0; attempt < 60; attempt++)
+    {
+        int workCount = 1 + attempt % 40;
+        auto works = GenerateWorks(workCount);
+        auto workers = GenerateWorkers(static_cast<size_t>(1 + attempt % 9), workCount, workCount / 2 + 1, generator);
+        CoverageIndex dense(works, workers);
+        CoverageIndex compressed(works, workers, 0);
+        REQUIRE(dense.HasMasks());
+        REQUIRE(!compressed.HasMasks());
+        REQUIRE(compressed.IsCoverable() == dense.IsCoverable());
+        for (size_t size = 1; size <= dense.GetWorkerCount(); size++)
+        {
+            auto team = FindTeamOfSize(dense, size);
+            REQUIRE(FindTeamOfSize(compressed, size) == team);
+            if (!team.empty())
+            {
+                REQUIRE(compressed.IsCovered(team.data(), team.size()));
+                REQUIRE(compressed.IsCovered(team.data() + 1, team.size() - 1)
+                        == dense.IsCovered(team.data() + 1, team.size() - 1));
+            }
+        }
+        REQUIRE(FindMinTeam(compressed, EnumerationOrder::Lexicographic)
+                == FindMinTeam(dense, EnumerationOrder::Lexicographic));
+        REQUIRE(FindMinTeamParallel(compressed, 2) == FindMinTeamParallel(dense, 2));
+    }
+
+    // Каталог из сотен тысяч работ: сжатые карты занимают порядка навыков
+    const int workCount = 200000;
+    Workers workers;
+    for (int id = 0; id < 4; id++)
+    {
+        for (int work = id * workCount / 4 + 1; work <= (id + 1) * workCount / 4; work++)
+        {
+            workers[id].push_back(work);
+        }
+    }
+    workers[4] = {1, 70000, 150000};
+    CoverageIndex index(GenerateWorks(workCount), workers, 1 << 16);
+    REQUIRE(!index.HasMasks());
+    REQUIRE(index.GetBitmap(4).GetSizeInBytes() < 1024);
+    REQUIRE(GetWorkerIds(index, FindMinTeam(index, EnumerationOrder::Lexicographic)) == std::vector<int>{0, 1, 2, 3});
+}
+
+TEST_CASE("Shared bound")
+{
+    SharedBound bound;
+    REQUIRE(bound.GetSize() == SIZE_MAX);
+    REQUIRE(!bound.GetTeam());
+    REQUIRE(bound.Offer({1, 2, 3}));
+    REQUIRE(!bound.Offer({4, 5, 6}));
+    REQUIRE(bound.Offer({7}));
+    REQUIRE(bound.GetSize() == 1);
+    REQUIRE(bound.GetTeam() == std::vector<size_t>{7});
+    REQUIRE(!bound.IsStopped());
+    REQUIRE(bound.Stop());
+    REQUIRE(!bound.Stop());
+    REQUIRE(bound.IsStopped());
+
+    // Перебор размера, до которого уже дошёл рекорд, сразу прекращается
+    Workers workers = {{1, {1}}, {2, {2}}, {3, {1, 2}}};
+    CoverageIndex index({1, 2}, workers);
+    SharedBound record;
+    REQUIRE(FindTeamOfSize(index, 2, std::nullopt, &record) == std::vector<size_t>{0, 1});
+    REQUIRE(record.Offer({2}));
+    REQUIRE(FindTeamOfSize(index, 2, std::nullopt, &record).empty());
+    REQUIRE(FindTeamOfSize(index, 1, std::nullopt, &record).empty());
+}
+
+TEST_CASE("Portfolio")
+{
+    std::mt19937 generator(43);
+    const std::vector<Strategy> all = {Strategy::DancingLinks, Strategy::BruteForce, Strategy::MeetInTheMiddle,
+                                       Strategy::Anytime};
+    for (int attempt = 0; attempt < 40; attempt++)
+    {
+        int workCount = 1 + attempt % 20;
+        auto works = GenerateWorks(workCount);
+        auto workers = GenerateWorkers(static_cast<size_t>(1 + attempt % 15), workCount, workCount / 3 + 1, generator);
+        CoverageIndex index(works, workers);
+
+        auto strategies = all;
+        std::rotate(strategies.begin(), strategies.begin() + attempt % 4, strategies.end());
+        auto result = RunPortfolio(index, strategies, 1 + attempt % 4);
+        RequireMinimumTeam(index, result.team);
+        REQUIRE(result.report.runs.size() == strategies.size());
+        if (!result.team)
+        {
+            continue;
+        }
+        REQUIRE(result.report.winner);
+        auto winners = std::count_if(result.report.runs.begin(), result.report.runs.end(), [](const StrategyRun& run) {
+            return run.outcome == StrategyOutcome::Won;
+        });
+        REQUIRE(winners == 1);
+    }
+
+    // Перебор по размерам на таком экземпляре не успевает, его останавливает DancingLinks
+    auto works = GenerateWorks(60);
+    auto workers = GenerateWorkers(60, 60, 6, generator);
+    CoverageIndex index(works, workers);
+    DancingLinks search(index);
+    auto expected = search.FindMinTeam();
+    REQUIRE(expected->size() >= 8);
+    auto result = RunPortfolio(index, {Strategy::BruteForce, Strategy::DancingLinks}, 2);
+    REQUIRE(result.team->size() == expected->size());
+    REQUIRE(result.report.winner == Strategy::DancingLinks);
+    REQUIRE(result.report.runs[0].outcome == StrategyOutcome::Cancelled);
+
+    // Точные стратегии здесь не успевают, их останавливает время
+    auto hardWorks = GenerateWorks(300);
+    CoverageIndex hard(hardWorks, GenerateWorkers(400, 300, 12, generator));
+    REQUIRE(hard.IsCoverable());
+    auto limited = RunPortfolio(hard, {Strategy::DancingLinks, Strategy::BruteForce}, 2, std::chrono::milliseconds(100));
+    REQUIRE(!limited.report.winner);
+    REQUIRE(hard.IsCovered(limited.team->data(), limited.team->size()));
+    REQUIRE(limited.report.runs[0].outcome == StrategyOutcome::Cancelled);
+
+    auto single = RunPortfolio(index, {Strategy::MeetInTheMiddle}, 1);
+    REQUIRE(single.report.runs[0].outcome == StrategyOutcome::NotApplicable);
+    REQUIRE(!single.report.winner);
+    REQUIRE(!single.team);
+    REQUIRE_THROWS_AS(GetStrategy("greedy"), std::invalid_argument);
+    REQUIRE(GetStrategy(GetStrategyName(Strategy::Anytime)) == Strategy::Anytime);
+    REQUIRE_THROWS_AS(RunPortfolio(index, {}, 1), std::invalid_argument);
+}
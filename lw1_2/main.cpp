@@ -1,33 +1,74 @@
-#include <iostream>
+#include "Team/Roster.h"
+#include "Team/BruteForce.h"
+#include "Team/DancingLinks.h"
+#include "Team/Anytime.h"
+#include "Team/ParallelSearch.h"
+#include "Team/Kernel.h"
+#include "Team/Incremental.h"
+#include "Team/Counting.h"
+#include "Team/MeetInTheMiddle.h"
+#include "Team/Portfolio.h"
 #include <algorithm>
+#include <iostream>
 #include <chrono>
-#include <fstream>
+#include <optional>
 #include <sstream>
+#include <thread>
 #include <vector>
-#include <map>
-
 
-using Workers = std::map<int, std::vector<int>>;
 
 const double NANO_IN_SECOND = 1000000000;
+const double DEFAULT_TIME_LIMIT = 1;
+
+enum class Mode
+{
+    BruteForce,
+    DancingLinks,
+    MeetInTheMiddle,
+    Anytime,
+    Parallel,
+    Portfolio,
+    Online,
+    Count,
+};
 
-struct InputFiles
+struct Input
 {
+    Mode mode = Mode::BruteForce;
+    // Без --time-limit: DEFAULT_TIME_LIMIT для --anytime, без ограничения для --portfolio
+    std::optional<double> timeLimit;
+    unsigned threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    bool isReduced = false;
+    bool isListed = false;
+    std::vector<Strategy> strategies = {Strategy::DancingLinks, Strategy::BruteForce, Strategy::MeetInTheMiddle,
+                                        Strategy::Anytime};
     std::string workFileName;
     std::string workersFileName;
 };
 
-InputFiles GetInput(int argc, char* argv[]);
-bool NextCombinations(size_t dim, std::vector<size_t>& state);
-std::vector<int> GetMinWorkers(const std::string& workFileName,
-                               const std::string& workersFileName);
-std::vector<int> GetWorks(std::ifstream& file);
-std::vector<int> GetKeys(const Workers& map);
-Workers GetWorkers(std::ifstream& file);
-bool IsWorkersEnough(const Workers& workersMap,
-                     const std::vector<int>& works);
+struct Result
+{
+    // Нет, если покрытие есть, но ни одна стратегия портфеля не нашла команду
+    std::optional<std::vector<int>> workers = std::nullopt;
+    // Только для приближённого поиска, когда покрытие есть
+    std::optional<size_t> lowerBound = std::nullopt;
+    std::optional<KernelReport> kernelReport = std::nullopt;
+    std::optional<PortfolioReport> portfolioReport = std::nullopt;
+};
+
+Input GetInput(int argc, char* argv[]);
+double GetSeconds(const std::string& argument, const std::string& prefix);
+unsigned GetThreadCount(const std::string& argument, const std::string& prefix);
+std::vector<Strategy> GetStrategies(const std::string& argument, const std::string& prefix);
+Result GetMinWorkers(const Input& input);
+void ReadRoster(const Input& input, std::vector<int>& works, Workers& workers);
+void RunOnline(const Input& input);
+void RunCount(const Input& input);
+void ApplyCommand(TeamEngine& engine, const std::string& line);
+Result Solve(const Input& input, const CoverageIndex& index);
 void PrintVector(const std::vector<int>& vector);
-void AssertFileIsOpen(std::ifstream& file);
+void PrintKernelReport(const KernelReport& report);
+void PrintPortfolioReport(const PortfolioReport& report);
 void AssertFileNumber(int argc);
 
 
@@ -35,16 +76,46 @@ int main(int argc, char* argv[])
 {
     try
     {
-        auto inputFiles = GetInput(argc, argv);
+        auto input = GetInput(argc, argv);
+        if (input.mode == Mode::Online)
+        {
+            RunOnline(input);
+            return 0;
+        }
+        if (input.mode == Mode::Count)
+        {
+            RunCount(input);
+            return 0;
+        }
         auto startTime = std::chrono::high_resolution_clock::now();
 
-        auto workers = GetMinWorkers(inputFiles.workFileName, inputFiles.workersFileName);
+        auto result = GetMinWorkers(input);
 
         auto endTime = std::chrono::high_resolution_clock::now();
         auto time = (endTime - startTime).count();
 
-        std::cout << "Требуемые работники: ";
-        PrintVector(workers);
+        if (result.workers)
+        {
+            std::cout << "Требуемые работники: ";
+            PrintVector(*result.workers);
+        }
+        else
+        {
+            std::cout << "Ни одна стратегия не нашла команду" << std::endl;
+        }
+        if (result.lowerBound)
+        {
+            std::cout << "Команда из " << result.workers->size() << " работников, оптимум не меньше "
+                      << *result.lowerBound << std::endl;
+        }
+        if (result.kernelReport)
+        {
+            PrintKernelReport(*result.kernelReport);
+        }
+        if (result.portfolioReport)
+        {
+            PrintPortfolioReport(*result.portfolioReport);
+        }
 
         std::cout << "Время выполнения: " << static_cast<double>(time) / NANO_IN_SECOND << std::endl;
     }
@@ -56,132 +127,340 @@ int main(int argc, char* argv[])
     return 0;
 }
 
-InputFiles GetInput(int argc, char* argv[])
-{
-    AssertFileNumber(argc);
-    return {
-        argv[1],
-        argv[2]
-    };
-}
-
-
-std::vector<int> GetMinWorkers(const std::string& workFileName,
-                               const std::string& workersFileName)
+// team [--kernel] [--dlx | --meet-in-the-middle | --anytime [--time-limit=SECONDS] | --parallel [--threads=N]
+//      | --portfolio[=СТРАТЕГИЯ,...] [--threads=N] [--time-limit=SECONDS] | --online]
+//      <файл работ> <файл работников>
+// team --count [--list] <файл работ> <файл работников>
+Input GetInput(int argc, char* argv[])
 {
-    std::ifstream worksFile(workFileName);
-    std::ifstream workersFile(workersFileName);
-    AssertFileIsOpen(worksFile);
-    AssertFileIsOpen(workersFile);
-
-    auto works = GetWorks(worksFile);
-    auto workersMap = GetWorkers(workersFile);
-
-    size_t workersNumber = workersMap.size();
-    for (size_t currentSize = 1; currentSize <= workersNumber; currentSize++)
+    Input input;
+    std::vector<std::string> fileNames;
+    for (int i = 1; i < argc; i++)
     {
-        std::vector<size_t> currentCombination(currentSize + 1);
-        for (size_t i = 1; i <= currentSize; i++)
+        std::string argument = argv[i];
+        if (argument == "--dlx")
+        {
+            input.mode = Mode::DancingLinks;
+        }
+        else if (argument == "--meet-in-the-middle")
+        {
+            input.mode = Mode::MeetInTheMiddle;
+        }
+        else if (argument == "--anytime")
+        {
+            input.mode = Mode::Anytime;
+        }
+        else if (argument == "--kernel")
+        {
+            input.isReduced = true;
+        }
+        else if (argument == "--count")
         {
-            currentCombination[i] = i;
+            input.mode = Mode::Count;
         }
-        do
+        else if (argument == "--list")
         {
-            Workers currentWorkers;
-            for (size_t i = 1; i <= currentSize; i++)
-            {
-                size_t index = currentCombination[i];
-                currentWorkers[index] = workersMap[index];
-            }
-            if (IsWorkersEnough(currentWorkers, works))
-            {
-                return GetKeys(currentWorkers);
-            }
-        } while (NextCombinations(workersNumber, currentCombination));
+            input.mode = Mode::Count;
+            input.isListed = true;
+        }
+        else if (argument == "--online")
+        {
+            input.mode = Mode::Online;
+        }
+        else if (argument == "--parallel")
+        {
+            input.mode = Mode::Parallel;
+        }
+        else if (argument == "--portfolio")
+        {
+            input.mode = Mode::Portfolio;
+        }
+        else if (argument.starts_with("--portfolio="))
+        {
+            input.mode = Mode::Portfolio;
+            input.strategies = GetStrategies(argument, "--portfolio=");
+        }
+        else if (argument.starts_with("--threads="))
+        {
+            input.threadCount = GetThreadCount(argument, "--threads=");
+        }
+        else if (argument.starts_with("--time-limit="))
+        {
+            input.timeLimit = GetSeconds(argument, "--time-limit=");
+        }
+        else if (argument.starts_with("--"))
+        {
+            throw std::invalid_argument("Unknown option: " + argument);
+        }
+        else
+        {
+            fileNames.push_back(argument);
+        }
+    }
+    AssertFileNumber(static_cast<int>(fileNames.size()) + 1);
+    // Сокращение убирает поглощённых работников и меняет число команд
+    if (input.mode == Mode::Count && input.isReduced)
+    {
+        throw std::invalid_argument("--kernel cannot be combined with --count");
     }
-    return GetKeys(workersMap);
+    input.workFileName = fileNames[0];
+    input.workersFileName = fileNames[1];
+    return input;
 }
 
-bool IsWorkersEnough(const Workers& workersMap,
-                     const std::vector<int>& works)
+double GetSeconds(const std::string& argument, const std::string& prefix)
 {
-    std::vector<int> resultWork;
-    for (const auto& worker : workersMap)
+    size_t end = 0;
+    double seconds = -1;
+    try
     {
-        resultWork.insert(resultWork.end(), worker.second.begin(), worker.second.end());
+        seconds = std::stod(argument.substr(prefix.size()), &end);
     }
-    std::sort(resultWork.begin(), resultWork.end());
-    auto last = std::unique(resultWork.begin(), resultWork.end());
-    resultWork.erase(last, resultWork.end());
-
-    return std::all_of(
-        works.begin(),
-        works.end(),
-        [&](int elem) -> bool {
-            return std::find(resultWork.begin(), resultWork.end(), elem) != resultWork.end();
-        }
-    );
+    catch (const std::exception&)
+    {
+    }
+    if (seconds < 0 || end != argument.size() - prefix.size())
+    {
+        throw std::invalid_argument("Wrong time limit: " + argument);
+    }
+    return seconds;
 }
 
-std::vector<int> GetWorks(std::ifstream& file)
+unsigned GetThreadCount(const std::string& argument, const std::string& prefix)
 {
-    std::vector<int> works;
+    size_t end = 0;
+    int count = 0;
+    try
+    {
+        count = std::stoi(argument.substr(prefix.size()), &end);
+    }
+    catch (const std::exception&)
+    {
+    }
+    if (count < 1 || end != argument.size() - prefix.size())
+    {
+        throw std::invalid_argument("Wrong thread count: " + argument);
+    }
+    return static_cast<unsigned>(count);
+}
 
-    int number;
-    while (file >> number)
+// Имена стратегий через запятую
+std::vector<Strategy> GetStrategies(const std::string& argument, const std::string& prefix)
+{
+    std::vector<Strategy> strategies;
+    std::istringstream stream(argument.substr(prefix.size()));
+    std::string name;
+    while (std::getline(stream, name, ','))
+    {
+        strategies.push_back(GetStrategy(name));
+    }
+    if (strategies.empty())
     {
-        works.push_back(number);
+        throw std::invalid_argument("Wrong strategy list: " + argument);
     }
-    return works;
+    return strategies;
 }
 
-Workers GetWorkers(std::ifstream& file)
+Result GetMinWorkers(const Input& input)
 {
-    std::map<int, std::vector<int>> workers;
-    std::string line;
+    auto works = LoadWorks(input.workFileName);
+    auto roster = LoadRoster(input.workersFileName);
+    if (!input.isReduced)
+    {
+        return Solve(input, CoverageIndex(works, roster));
+    }
 
-    while (std::getline(file, line))
+    auto kernel = Reduce(works, ToWorkers(roster));
+    Result result{.workers = std::vector<int>{}};
+    if (!kernel.works.empty())
+    {
+        result = Solve(input, CoverageIndex(kernel.works, kernel.workers));
+    }
+    if (result.workers)
+    {
+        result.workers = ExpandTeam(kernel, *result.workers);
+    }
+    if (result.lowerBound)
     {
-        std::istringstream iss(line);
-        std::vector<int> data;
-        int number;
+        *result.lowerBound += kernel.forcedWorkers.size();
+    }
+    result.kernelReport = kernel.report;
+    return result;
+}
 
-        while (iss >> number)
+void ReadRoster(const Input& input, std::vector<int>& works, Workers& workers)
+{
+    works = LoadWorks(input.workFileName);
+    workers = ToWorkers(LoadRoster(input.workersFileName));
+}
+
+// После начальных файлов читает команды со стандартного ввода, по одной на строку:
+//   add-worker <id> [работа...]    remove-worker <id>
+//   add-skill <id> <работа>        remove-skill <id> <работа>
+//   add-work <работа>              remove-work <работа>
+// и после каждой выводит команду и время пересчёта
+void RunOnline(const Input& input)
+{
+    std::vector<int> works;
+    Workers workers;
+    ReadRoster(input, works, workers);
+    TeamEngine engine(works, workers);
+    std::cout << "Требуемые работники: ";
+    PrintVector(engine.GetTeam());
+
+    std::string line;
+    while (std::getline(std::cin, line))
+    {
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
         {
-            data.push_back(number);
+            continue;
         }
-        int worker = data[0];
-        std::vector<int> works(data.begin() + 1, data.end());
+        try
+        {
+            auto startTime = std::chrono::high_resolution_clock::now();
+            ApplyCommand(engine, line);
+            auto endTime = std::chrono::high_resolution_clock::now();
+            auto time = (endTime - startTime).count();
 
-        workers[worker] = works;
+            std::cout << "Требуемые работники: ";
+            PrintVector(engine.GetTeam());
+            std::cout << "Время выполнения: " << static_cast<double>(time) / NANO_IN_SECOND << std::endl;
+        }
+        catch (const std::invalid_argument& exception)
+        {
+            std::cout << exception.what() << std::endl;
+        }
     }
-    return workers;
 }
 
-bool NextCombinations(size_t dim, std::vector<size_t>& state) {
-    size_t k = state.size() - 1;
-    size_t m = k;
-    while (state[m] == dim - k + m)
+// Размер и число наименьших команд, с --list перед ними выводится каждая команда,
+// и команды считаются при выводе
+void RunCount(const Input& input)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+    auto works = LoadWorks(input.workFileName);
+    CoverageIndex index(works, LoadRoster(input.workersFileName));
+    TeamCount teamCount{0, 0};
+    if (input.isListed)
     {
-        m = m - 1;
+        DancingLinks search(index);
+        teamCount.size = search.ForEachMinTeam([&](const std::vector<size_t>& team) {
+            std::cout << "Команда: ";
+            PrintVector(GetWorkerIds(index, team));
+            teamCount.count++;
+        });
     }
-    state[m] = state[m] + 1;
-    for (size_t i = m + 1; i <= k; i++)
+    else
     {
-        state[i] = state[i - 1] + 1;
+        teamCount = CountMinTeams(index);
     }
-    return m != 0;
+    auto [size, count] = teamCount;
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto time = (endTime - startTime).count();
+
+    std::cout << "Размер наименьшей команды: " << size << std::endl;
+    std::cout << "Наименьших команд: " << count << std::endl;
+    std::cout << "Время выполнения: " << static_cast<double>(time) / NANO_IN_SECOND << std::endl;
 }
 
-std::vector<int> GetKeys(const Workers& map)
+void ApplyCommand(TeamEngine& engine, const std::string& line)
 {
-    std::vector<int> keys;
+    std::istringstream stream(line);
+    std::string command;
+    stream >> command;
+    std::vector<int> numbers;
+    int number;
+    while (stream >> number)
+    {
+        numbers.push_back(number);
+    }
+    if (!stream.eof())
+    {
+        throw std::invalid_argument("Wrong command: " + line);
+    }
+
+    auto assertArgumentNumber = [&](size_t count) {
+        if (numbers.size() != count)
+        {
+            throw std::invalid_argument("Wrong argument number: " + line);
+        }
+    };
+    if (command == "add-worker" && !numbers.empty())
+    {
+        engine.AddWorker(numbers[0], std::vector<int>(numbers.begin() + 1, numbers.end()));
+    }
+    else if (command == "remove-worker")
+    {
+        assertArgumentNumber(1);
+        engine.RemoveWorker(numbers[0]);
+    }
+    else if (command == "add-skill")
+    {
+        assertArgumentNumber(2);
+        engine.AddSkill(numbers[0], numbers[1]);
+    }
+    else if (command == "remove-skill")
+    {
+        assertArgumentNumber(2);
+        engine.RemoveSkill(numbers[0], numbers[1]);
+    }
+    else if (command == "add-work")
+    {
+        assertArgumentNumber(1);
+        engine.AddWork(numbers[0]);
+    }
+    else if (command == "remove-work")
+    {
+        assertArgumentNumber(1);
+        engine.RemoveWork(numbers[0]);
+    }
+    else
+    {
+        throw std::invalid_argument("Wrong command: " + line);
+    }
+}
 
-    for (const auto& item : map)
+Result Solve(const Input& input, const CoverageIndex& index)
+{
+    if (input.mode == Mode::Anytime)
+    {
+        auto timeLimit = std::chrono::duration<double>(input.timeLimit.value_or(DEFAULT_TIME_LIMIT));
+        auto result = FindTeamAnytime(index, std::chrono::duration_cast<std::chrono::milliseconds>(timeLimit));
+        if (!result.team)
+        {
+            return {.workers = GetWorkerIds(index, result.team)};
+        }
+        return {.workers = GetWorkerIds(index, result.team), .lowerBound = result.lowerBound};
+    }
+    if (input.mode == Mode::Parallel)
+    {
+        return {.workers = GetWorkerIds(index, FindMinTeamParallel(index, input.threadCount))};
+    }
+    if (input.mode == Mode::Portfolio)
+    {
+        std::optional<std::chrono::milliseconds> timeLimit;
+        if (input.timeLimit)
+        {
+            auto seconds = std::chrono::duration<double>(*input.timeLimit);
+            timeLimit = std::chrono::duration_cast<std::chrono::milliseconds>(seconds);
+        }
+        auto result = RunPortfolio(index, input.strategies, input.threadCount, timeLimit);
+        if (!result.team && index.IsCoverable())
+        {
+            return {std::nullopt, std::nullopt, std::nullopt, result.report};
+        }
+        return {GetWorkerIds(index, result.team), std::nullopt, std::nullopt, result.report};
+    }
+    if (input.mode == Mode::MeetInTheMiddle)
+    {
+        return {.workers = GetWorkerIds(index, FindMinTeamMeetInTheMiddle(index))};
+    }
+    if (input.mode == Mode::DancingLinks)
     {
-        keys.push_back(item.first);
+        DancingLinks search(index);
+        return {.workers = GetWorkerIds(index, search.FindMinTeam())};
     }
-    return keys;
+    return {.workers = GetWorkerIds(index, FindMinTeam(index, SelectEnumerationOrder(index)))};
 }
 
 void PrintVector(const std::vector<int>& vector)
@@ -193,19 +472,61 @@ void PrintVector(const std::vector<int>& vector)
     std::cout << std::endl;
 }
 
-void AssertFileNumber(int argc)
+void PrintKernelReport(const KernelReport& report)
+{
+    std::cout << "Сокращение (проходов: " << report.rounds << "): без навыков " << report.emptyWorkers
+              << ", повторов " << report.duplicateWorkers << ", поглощённых " << report.dominatedWorkers
+              << ", обязательных " << report.forcedWorkers << ", покрытых ими работ " << report.coveredWorks
+              << std::endl;
+    std::cout << "Ядро: " << report.kernelWorkers << " работников, " << report.kernelWorks << " работ"
+              << std::endl;
+}
+
+void PrintPortfolioReport(const PortfolioReport& report)
 {
-    const int fileNumber = 2;
-    if (argc == fileNumber)
+    std::cout << "Победила стратегия: "
+              << (report.winner ? GetStrategyName(*report.winner) : "нет, оптимальность не доказана") << std::endl;
+    for (const auto& run : report.runs)
     {
-        throw std::invalid_argument("Wrong argument number");
+        std::cout << "  " << GetStrategyName(run.strategy) << ": ";
+        switch (run.outcome)
+        {
+        case StrategyOutcome::Won:
+            std::cout << "доказала оптимальность первой";
+            break;
+        case StrategyOutcome::Proved:
+            std::cout << "доказала оптимальность";
+            break;
+        case StrategyOutcome::Finished:
+            std::cout << "закончила без доказательства";
+            break;
+        case StrategyOutcome::NotApplicable:
+            std::cout << "не подходит";
+            break;
+        case StrategyOutcome::Cancelled:
+            std::cout << "остановлена";
+            break;
+        case StrategyOutcome::NotStarted:
+            std::cout << "не запускалась";
+            break;
+        }
+        if (run.teamSize)
+        {
+            std::cout << ", команда из " << *run.teamSize;
+        }
+        if (run.outcome != StrategyOutcome::NotStarted)
+        {
+            std::cout << ", " << static_cast<double>(run.elapsed.count()) / 1000000 << " с";
+        }
+        std::cout << std::endl;
     }
 }
 
-void AssertFileIsOpen(std::ifstream& file)
+void AssertFileNumber(int argc)
 {
-    if (file.fail())
+    const int argumentNumber = 3;
+    if (argc != argumentNumber)
     {
-        throw std::invalid_argument("Failed to open input file");
+        throw std::invalid_argument("Wrong argument number");
     }
 }
\ No newline at end of file